@@ -169,8 +169,10 @@ int main( int argc, char *argv[] ) {
 	exit( 1 );
     } // try
 
+    uTime start = uThisProcessor().getClock().getTime();
     new Mall( nHost, nCham );
     uActor::stop();					// wait for all actors to terminate
+    cout << "elapsed " << ( uThisProcessor().getClock().getTime() - start ).nanoseconds() / 1000 << " us" << endl;
 } // main
 
 // Local Variables: //
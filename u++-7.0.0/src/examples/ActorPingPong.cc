@@ -24,6 +24,10 @@
 // along  with this library.
 // 
 
+// Each pair of actors cycles its own ping and pong messages, so sends use the message's envelope and need no
+// allocation. The messages are not members of the actors because an actor deletes itself while still processing a
+// message. The message throughput over all pairs is reported.
+
 #include <iostream>
 using namespace std;
 #include <uActor.h>
@@ -34,10 +38,11 @@ using namespace std;
 #define PRT( stmt ) stmt
 #endif // NOOUTPUT
 
-struct PingMsg : public uActor::Message {} pingMsg;
-struct PongMsg : public uActor::Message {} pongMsg;
+struct PingMsg : public uActor::Message {};
+struct PongMsg : public uActor::Message {};
 
 _Actor Ping {
+    PingMsg & pingMsg;
     int cycle = 0, cycles;
 
     Allocation receive( Message &msg ) {
@@ -55,10 +60,12 @@ _Actor Ping {
 	return Nodelete;				// reuse actor
     } // Ping::receive
   public:
-    Ping( int cycles = 10 ) : cycles( cycles ) {}
+    Ping( PingMsg & pingMsg, int cycles = 10 ) : pingMsg( pingMsg ), cycles( cycles ) {}
 }; // Ping
 
 _Actor Pong {
+    PongMsg & pongMsg;
+
     Allocation receive( Message &msg ) {
 	Case( PingMsg, msg ) {				// determine message kind
 	    PRT( cout << "pong" << endl; )
@@ -69,13 +76,18 @@ _Actor Pong {
 	} // Case
 	return Nodelete;				// reuse actor
     } // Pong::receive
+  public:
+    Pong( PongMsg & pongMsg ) : pongMsg( pongMsg ) {}
 }; // Pong
 
 int main( int argc, char *argv[] ) {
-    int Cycles = 10;					// default values
+    int Cycles = 10, Pairs = 1;				// default values
 
     try {
 	switch ( argc ) {
+	  case 3:
+	    Pairs = stoi( argv[2] );
+	    if ( Pairs < 1 ) throw 1;
 	  case 2:
 	    Cycles = stoi( argv[1] );
 	    if ( Cycles < 1 ) throw 1;
@@ -85,14 +97,24 @@ int main( int argc, char *argv[] ) {
 	    throw 1;
 	} // switch
     } catch( ... ) {
-	cout << "Usage: " << argv[0] << " [ cycles (> 0) ]" << endl;
+	cout << "Usage: " << argv[0] << " [ cycles (> 0) [ pairs (> 0) ] ]" << endl;
 	exit( 1 );
     } // try
 
-    Ping *ping = new Ping( Cycles );
-    Pong *pong = new Pong;
-    ping->tell( pongMsg, pong );			// start cycling
+    PingMsg pingMsgs[Pairs];
+    PongMsg pongMsgs[Pairs];
+    uTime start = uThisProcessor().getClock().getTime();
+    for ( int p = 0; p < Pairs; p += 1 ) {
+	Ping *ping = new Ping( pingMsgs[p], Cycles );
+	Pong *pong = new Pong( pongMsgs[p] );
+	ping->tell( pongMsgs[p], pong );		// start cycling
+    } // for
     uActor::stop();					// wait for all actors to terminate
+    uDuration elapsed = uThisProcessor().getClock().getTime() - start;
+
+    long int messages = 2l * ( Cycles + 1 ) * Pairs;
+    cout << messages << " messages " << elapsed.nanoseconds() / messages << " ns/message "
+	 << (long int)( messages / ( elapsed.nanoseconds() / 1.0E9 ) ) << " messages/second" << endl;
 } // main
 
 // Local Variables: //
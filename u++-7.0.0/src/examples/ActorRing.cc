@@ -24,6 +24,9 @@
 // along  with this library.
 // 
 
+// A token is passed around a ring of actors; each pass is a send that uses the token's envelope and needs no
+// allocation. The message throughput is reported.
+
 #include <iostream>
 using namespace std;
 #include <uActor.h>
@@ -94,8 +97,14 @@ int main( int argc, char *argv[] ) {
     } // for
     passers[RingSize - 1]->close( passers[0] );		// close cycle by linking head to tail
     
+    uTime start = uThisProcessor().getClock().getTime();
     *passers[0] | token;				// start cycling token
     uActor::stop();					// wait for all actors to terminate
+    uDuration elapsed = uThisProcessor().getClock().getTime() - start;
+
+    long int messages = token.cnt;			// one receive per pass
+    cout << messages << " messages " << elapsed.nanoseconds() / messages << " ns/message "
+	 << (long int)( messages / ( elapsed.nanoseconds() / 1.0E9 ) ) << " messages/second" << endl;
 } // main
 
 // Local Variables: //
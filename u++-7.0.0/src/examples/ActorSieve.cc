@@ -28,6 +28,12 @@
 using namespace std;
 #include <uActor.h>
 
+#ifdef NOOUTPUT						// disable printing for experiments
+#define PRT( stmt )
+#else
+#define PRT( stmt ) stmt
+#endif // NOOUTPUT
+
 unsigned int uDefaultActorThreads() { return 1; }	// 1 => user thread
 unsigned int uDefaultActorProcessors() { return 0; }	// 0 => 1 kernel thread from user cluster
 
@@ -79,7 +85,7 @@ _Actor Sieve {
 
     Allocation receive( Message &msg ) {
 	Case( Number, msg ) {				// determine message kind
-	    osacquire( cout ) << msg_t->n << endl;	// print reported prime
+	    PRT( osacquire( cout ) << msg_t->n << endl; ) // print reported prime
 	} else Case( StopMsg, msg ) {
 	    osacquire( cout ) << "all done" << endl;
 	    return Delete;				// delete actor
@@ -108,8 +114,10 @@ int main( int argc, char *argv[] ) {
 	exit( 1 );
     } // try
 
+    uTime start = uThisProcessor().getClock().getTime();
     new Sieve( Max );
     uActor::stop();					// wait for all actors to terminate
+    cout << "elapsed " << ( uThisProcessor().getClock().getTime() - start ).nanoseconds() / 1000 << " us" << endl;
 } // main
 
 // Local Variables: //
@@ -0,0 +1,110 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 7.0.0, Copyright (C) Peter A. Buhr 2018
+//
+// Barrier.cc -- Cost of a barrier episode for a monitor barrier and a combining-tree barrier.
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// Tasks repeatedly meet at a uBarrier, whose last task restarts the others with uCondition::signalAll, and then at a
+// uTreeBarrier. After each episode, every task checks all tasks reached it, and the time per episode is reported.
+
+#include <iostream>
+#include <iomanip>
+using namespace std;
+#include <cstdlib>					// atoi
+#include <uBarrier.h>
+
+enum { Episodes = 20000 };
+
+unsigned int tasks;
+volatile unsigned int arrived[2];			// per barrier, arrivals in all episodes
+
+_Task Monitor {						// uBarrier participant
+    uBarrier &barrier;
+
+    void main() {
+	for ( unsigned int e = 1; e <= Episodes; e += 1 ) {
+	    uFetchAdd( arrived[0], 1 );
+	    barrier.block();
+	    if ( arrived[0] < e * tasks ) abort( "uBarrier released early" );
+	} // for
+    } // Monitor::main
+  public:
+    Monitor( uBarrier &barrier ) : barrier( barrier ) {}
+}; // Monitor
+
+_Task Tree {						// uTreeBarrier participant
+    uTreeBarrier &barrier;
+    unsigned int id;
+
+    void main() {
+	for ( unsigned int e = 1; e <= Episodes; e += 1 ) {
+	    uFetchAdd( arrived[1], 1 );
+	    barrier.block( id );
+	    if ( arrived[1] < e * tasks ) abort( "uTreeBarrier released early" );
+	} // for
+    } // Tree::main
+  public:
+    Tree( uTreeBarrier &barrier, unsigned int id ) : barrier( barrier ), id( id ) {}
+}; // Tree
+
+int main( int argc, char *argv[] ) {
+    unsigned int procs = 4;
+    tasks = 64;
+    switch ( argc ) {
+      case 3:
+	tasks = atoi( argv[2] );
+      case 2:
+	procs = atoi( argv[1] );
+      case 1:
+	break;
+      default:
+	procs = 0;
+    } // switch
+    if ( procs < 1 || tasks < 1 ) {
+	cerr << "Usage: " << argv[0] << " [ processors (> 0) [ tasks (> 0) ] ]" << endl;
+	exit( EXIT_FAILURE );
+    } // if
+    uProcessor *processors = new uProcessor[procs - 1];
+
+    uTime start = uThisProcessor().getClock().getTime();
+    {
+	uBarrier barrier( tasks );
+	Monitor **participants = new Monitor *[tasks];
+	for ( unsigned int i = 0; i < tasks; i += 1 ) participants[i] = new Monitor( barrier );
+	for ( unsigned int i = 0; i < tasks; i += 1 ) delete participants[i];
+	delete [] participants;
+    }
+    uTime end = uThisProcessor().getClock().getTime();
+    cout << "uBarrier     " << setw(8) << ( end - start ).nanoseconds() / Episodes << " ns/episode" << endl;
+
+    start = uThisProcessor().getClock().getTime();
+    {
+	uTreeBarrier barrier( tasks );
+	Tree **participants = new Tree *[tasks];
+	for ( unsigned int i = 0; i < tasks; i += 1 ) participants[i] = new Tree( barrier, i );
+	for ( unsigned int i = 0; i < tasks; i += 1 ) delete participants[i];
+	delete [] participants;
+    }
+    end = uThisProcessor().getClock().getTime();
+    cout << "uTreeBarrier " << setw(8) << ( end - start ).nanoseconds() / Episodes << " ns/episode" << endl;
+
+    delete [] processors;
+} // main
+
+// Local Variables: //
+// compile-command: "u++-work -O2 -multi Barrier.cc" //
+// End: //
@@ -0,0 +1,101 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 7.0.0, Copyright (C) Peter A. Buhr 2018
+//
+// Cofor.cc -- Fine-grained COFOR loop compared with a task per iteration.
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// The rows of an image are brightened with COFOR, whose iterations run in chunks on one worker per processor, and
+// with START/WAIT, which creates a task per row. Rows have uneven cost so COFOR must steal to balance. The time for
+// each and the time per row are reported.
+
+#include <iostream>
+#include <iomanip>
+using namespace std;
+#include <cstdlib>					// atoi
+#include <uCobegin.h>
+
+enum { Cols = 256, Batch = 1000 };
+
+static void brighten( unsigned char *row, unsigned int passes ) {
+    for ( unsigned int p = 0; p < passes; p += 1 ) {
+	for ( unsigned int c = 0; c < Cols; c += 1 ) row[c] = row[c] < 255 ? row[c] + 1 : 255;
+    } // for
+} // brighten
+
+int main( int argc, char *argv[] ) {
+    unsigned int procs = 4, rows = 100000;
+    switch ( argc ) {
+      case 3:
+	rows = atoi( argv[2] );
+      case 2:
+	procs = atoi( argv[1] );
+      case 1:
+	break;
+      default:
+	procs = 0;
+    } // switch
+    if ( procs < 1 || rows < 1 ) {
+	cerr << "Usage: " << argv[0] << " [ processors (> 0) [ rows (> 0) ] ]" << endl;
+	exit( EXIT_FAILURE );
+    } // if
+    uProcessor *processors = new uProcessor[procs - 1];
+
+    unsigned char (*image)[Cols] = new unsigned char[rows][Cols]();
+
+    uTime start = uThisProcessor().getClock().getTime();
+    COFOR( row, 0, rows,
+	brighten( image[row], 1 + row % 8 );		// uneven rows
+    ); // COFOR
+    uTime end = uThisProcessor().getClock().getTime();
+    long int cofor = ( end - start ).nanoseconds();
+
+    start = uThisProcessor().getClock().getTime();
+    {
+	typedef decltype( START( brighten, image[0], 1u ) ) Handle;
+	Handle *handles = new Handle[Batch];
+	for ( unsigned int base = 0; base < rows; base += Batch ) { // bound number of task stacks
+	    unsigned int batch = rows - base < Batch ? rows - base : Batch;
+	    for ( unsigned int i = 0; i < batch; i += 1 ) {
+		unsigned int row = base + i;
+		handles[i] = START( brighten, image[row], 1 + row % 8 );
+	    } // for
+	    for ( unsigned int i = 0; i < batch; i += 1 ) {
+		WAIT( handles[i] );
+		handles[i].reset();			// deleting task waits for it
+	    } // for
+	} // for
+	delete [] handles;
+    }
+    end = uThisProcessor().getClock().getTime();
+    long int tasks = ( end - start ).nanoseconds();
+
+    for ( unsigned int row = 0; row < rows; row += 1 ) {
+	for ( unsigned int c = 0; c < Cols; c += 1 ) {
+	    if ( image[row][c] != 2 * ( 1 + row % 8 ) ) abort( "row %u not brightened exactly twice", row );
+	} // for
+    } // for
+    delete [] image;
+
+    cout << "COFOR         " << setw(10) << cofor / 1000000 << " ms " << setw(6) << cofor / rows << " ns/row" << endl;
+    cout << "task per row  " << setw(10) << tasks / 1000000 << " ms " << setw(6) << tasks / rows << " ns/row" << endl;
+
+    delete [] processors;
+} // main
+
+// Local Variables: //
+// compile-command: "u++-work -O2 -multi Cofor.cc" //
+// End: //
@@ -0,0 +1,189 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 7.0.0, Copyright (C) Peter A. Buhr 2018
+//
+// CombiningBB.cc -- Contended monitor operations with and without flat combining.
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// Producers and consumers, one per processor, pass Items values through a uBoundedBuffer and through a bounded buffer
+// whose queue operations are run by uCombining, with semaphores counting the full and empty slots. Then tasks increment
+// a shared counter through a _Monitor and through uCombining. The elapsed time and, for combining, the average number
+// of operations run per combining pass are reported.
+
+#include <iostream>
+#include <iomanip>
+using namespace std;
+#include <cstdlib>					// atoi
+#include <uBoundedBuffer.h>
+#include <uCombining.h>
+#include <uSemaphore.h>
+
+unsigned int uDefaultPreemption() {
+    return 0;						// no timeslicing to disturb the measurements
+} // uDefaultPreemption
+
+enum { Size = 64, Items = 200000, Increments = 500000 };
+
+class Queue {						// sequential queue, run by combiner
+    int elems[Size];
+    unsigned int front = 0, back = 0;
+  public:
+    void push( int elem ) {
+	elems[back] = elem;
+	back = ( back + 1 ) % Size;
+    } // Queue::push
+
+    int pop() {
+	int elem = elems[front];
+	front = ( front + 1 ) % Size;
+	return elem;
+    } // Queue::pop
+}; // Queue
+
+class CombiningBuffer {
+    uSemaphore full, empty;				// count used and free elements
+  public:
+    uCombining< Queue > queue;
+
+    CombiningBuffer() : full( 0 ), empty( Size ) {}
+
+    void insert( int elem ) {
+	empty.P();
+	queue( [elem]( Queue &q ) { q.push( elem ); } );
+	full.V();
+    } // CombiningBuffer::insert
+
+    int remove() {
+	full.P();
+	int elem = queue( []( Queue &q ) { return q.pop(); } );
+	empty.V();
+	return elem;
+    } // CombiningBuffer::remove
+}; // CombiningBuffer
+
+_Monitor Counter {
+    unsigned long int cnt = 0;
+  public:
+    void inc() { cnt += 1; }
+    unsigned long int count() { return cnt; }
+}; // Counter
+
+struct Count {						// sequential counter, run by combiner
+    unsigned long int cnt = 0;
+}; // Count
+
+template< typename Buffer > _Task Producer {
+    Buffer &buffer;
+    unsigned int items;
+
+    void main() {
+	for ( unsigned int i = 1; i <= items; i += 1 ) buffer.insert( i );
+    } // Producer::main
+  public:
+    Producer( Buffer &buffer, unsigned int items ) : buffer( buffer ), items( items ) {}
+}; // Producer
+
+template< typename Buffer > _Task Consumer {
+    Buffer &buffer;
+    unsigned int items;
+    unsigned long int &sum;
+
+    void main() {
+	unsigned long int s = 0;
+	for ( unsigned int i = 0; i < items; i += 1 ) s += buffer.remove();
+	sum = s;
+    } // Consumer::main
+  public:
+    Consumer( Buffer &buffer, unsigned int items, unsigned long int &sum ) : buffer( buffer ), items( items ), sum( sum ) {}
+}; // Consumer
+
+template< typename Incr > _Task Incrementer {
+    Incr incr;
+
+    void main() {
+	for ( unsigned int i = 0; i < Increments; i += 1 ) incr();
+    } // Incrementer::main
+  public:
+    Incrementer( Incr incr ) : incr( incr ) {}
+}; // Incrementer
+
+template< typename Buffer > static long int transfer( Buffer &buffer, unsigned int pairs ) { // milliseconds
+    unsigned int items = Items / pairs;
+    unsigned long int *sums = new unsigned long int[pairs];
+    uTime start = uThisProcessor().getClock().getTime();
+    {
+	Producer< Buffer > **producers = new Producer< Buffer > *[pairs];
+	Consumer< Buffer > **consumers = new Consumer< Buffer > *[pairs];
+	for ( unsigned int i = 0; i < pairs; i += 1 ) {
+	    producers[i] = new Producer< Buffer >( buffer, items );
+	    consumers[i] = new Consumer< Buffer >( buffer, items, sums[i] );
+	} // for
+	for ( unsigned int i = 0; i < pairs; i += 1 ) {
+	    delete producers[i];
+	    delete consumers[i];
+	} // for
+	delete [] producers;
+	delete [] consumers;
+    }
+    uTime end = uThisProcessor().getClock().getTime();
+    unsigned long int sum = 0;
+    for ( unsigned int i = 0; i < pairs; i += 1 ) sum += sums[i];
+    delete [] sums;
+    if ( sum != (unsigned long int)pairs * items * ( items + 1 ) / 2 ) abort( "buffer lost elements" );
+    return ( end - start ).nanoseconds() / 1000000;
+} // transfer
+
+template< typename Incr > static long int increment( Incr incr, unsigned int tasks ) { // milliseconds
+    uTime start = uThisProcessor().getClock().getTime();
+    {
+	Incrementer< Incr > **incrementers = new Incrementer< Incr > *[tasks];
+	for ( unsigned int i = 0; i < tasks; i += 1 ) incrementers[i] = new Incrementer< Incr >( incr );
+	for ( unsigned int i = 0; i < tasks; i += 1 ) delete incrementers[i];
+	delete [] incrementers;
+    }
+    return ( uThisProcessor().getClock().getTime() - start ).nanoseconds() / 1000000;
+} // increment
+
+int main( int argc, char *argv[] ) {
+    unsigned int procs = 4;
+    if ( argc > 1 ) procs = atoi( argv[1] );
+    if ( procs < 1 ) {
+	cerr << "Usage: " << argv[0] << " [ processors (> 0) ]" << endl;
+	exit( EXIT_FAILURE );
+    } // if
+    uProcessor *processors = new uProcessor[procs - 1];
+
+    cout << setprecision(1) << fixed;
+    uBoundedBuffer< int > bb( Size );
+    cout << "uBoundedBuffer  " << setw(8) << transfer( bb, procs ) << " ms" << endl;
+    CombiningBuffer cb;
+    long int ms = transfer( cb, procs );
+    cout << "combining buffer" << setw(8) << ms << " ms, " << (double)cb.queue.combined() / cb.queue.batches() << " ops/pass" << endl;
+
+    Counter counter;
+    cout << "_Monitor counter " << setw(7) << increment( [&counter]() { counter.inc(); }, procs ) << " ms" << endl;
+    if ( counter.count() != (unsigned long int)procs * Increments ) abort( "monitor counter lost increments" );
+    uCombining< Count > count;
+    ms = increment( [&count]() { count( []( Count &c ) { c.cnt += 1; } ); }, procs );
+    cout << "combining counter" << setw(7) << ms << " ms, " << (double)count.combined() / count.batches() << " ops/pass" << endl;
+    if ( count( []( Count &c ) { return c.cnt; } ) != (unsigned long int)procs * Increments ) abort( "combining counter lost increments" );
+
+    delete [] processors;
+} // main
+
+// Local Variables: //
+// compile-command: "u++-work -O2 -multi CombiningBB.cc" //
+// End: //
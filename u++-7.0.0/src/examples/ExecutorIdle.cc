@@ -0,0 +1,64 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 7.0.0, Copyright (C) Peter A. Buhr 2018
+//
+// ExecutorIdle.cc -- CPU used by an idle executor and round-trip latency of a busy one.
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// The process CPU time consumed while the executor has no work should be near zero, because idle workers park instead
+// of polling their mailboxes. The average sendrecv round trip is reported for back-to-back requests (workers spinning)
+// and for requests separated by a pause (workers parked).
+
+#include <iostream>
+using namespace std;
+#include <uFuture.h>
+#include <sys/resource.h>				// getrusage
+
+enum { Requests = 100000, Paused = 100 };
+
+static long int cpu() {					// process CPU time in microseconds
+    struct rusage usage;
+    getrusage( RUSAGE_SELF, &usage );
+    return ( usage.ru_utime.tv_sec + usage.ru_stime.tv_sec ) * 1000000l + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+} // cpu
+
+int main() {
+    uExecutor executor;
+
+    uTime start = uThisProcessor().getClock().getTime();
+    for ( unsigned int i = 0; i < Requests; i += 1 ) {
+	executor.sendrecv( [i]() { return i; } )();
+    } // for
+    cout << "busy round trip " << ( uThisProcessor().getClock().getTime() - start ).nanoseconds() / Requests << " ns" << endl;
+
+    uDuration pause( 0, 10000000 );			// 10 milliseconds
+    long int total = 0;
+    for ( unsigned int i = 0; i < Paused; i += 1 ) {
+	uThisTask().sleep( pause );
+	start = uThisProcessor().getClock().getTime();
+	executor.sendrecv( [i]() { return i; } )();
+	total += ( uThisProcessor().getClock().getTime() - start ).nanoseconds();
+    } // for
+    cout << "parked round trip " << total / Paused << " ns" << endl;
+
+    long int before = cpu();
+    uThisTask().sleep( uDuration( 1 ) );		// executor idle
+    cout << "idle CPU " << ( cpu() - before ) / 10000 << "% of one core" << endl;
+} // main
+
+// Local Variables: //
+// compile-command: "u++-work -O2 -multi ExecutorIdle.cc" //
+// End: //
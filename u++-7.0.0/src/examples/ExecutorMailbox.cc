@@ -0,0 +1,76 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 7.0.0, Copyright (C) Peter A. Buhr 2018
+//
+// ExecutorMailbox.cc -- Compare the executor mailbox implementations across numbers of producers.
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// Producer tasks send empty requests to an executor as fast as possible, and the request throughput is reported for
+// each mailbox implementation (lock-free, spin lock, monitor) and number of producers.
+
+#include <iostream>
+#include <iomanip>
+using namespace std;
+#include <cstdlib>					// atoi
+#include <uFuture.h>
+
+enum { Workers = 4, MaxProducers = 8 };
+unsigned int Requests = 1000000;			// per producer
+
+static volatile unsigned long int done;
+
+_Task Producer {
+    uExecutor & executor;
+
+    void main() {
+	for ( unsigned int i = 0; i < Requests; i += 1 ) {
+	    executor.send( []() { uFetchAdd( done, 1 ); } );
+	} // for
+    } // Producer::main
+  public:
+    Producer( uExecutor & executor ) : executor( executor ) {}
+}; // Producer
+
+int main( int argc, char *argv[] ) {
+    if ( argc > 1 ) Requests = atoi( argv[1] );
+    if ( Requests < 1 ) {
+	cerr << "Usage: " << argv[0] << " [ requests per producer (> 0) ]" << endl;
+	exit( EXIT_FAILURE );
+    } // if
+
+    uProcessor processors[MaxProducers - 1];		// producers run in parallel with executor
+    const char *names[] = { "lock-free", "spin lock", "monitor" };
+    cout << setw(10) << "mailbox" << setw(10) << "producers" << setw(14) << "requests/s" << endl;
+    for ( int kind = uExecutor::LockFree; kind <= uExecutor::Monitor; kind += 1 ) {
+	for ( unsigned int producers = 1; producers <= MaxProducers; producers *= 2 ) {
+	    uExecutor executor( Workers, Workers, Workers, -1, true, (uExecutor::Mailbox)kind );
+	    done = 0;
+	    uTime start = uThisProcessor().getClock().getTime();
+	    {
+		Producer *tasks[producers];
+		for ( unsigned int p = 0; p < producers; p += 1 ) tasks[p] = new Producer( executor );
+		for ( unsigned int p = 0; p < producers; p += 1 ) delete tasks[p];
+	    }
+	    while ( done != (unsigned long int)producers * Requests ) uThisTask().yield(); // wait for requests to run
+	    double seconds = ( uThisProcessor().getClock().getTime() - start ).nanoseconds() / 1.0E9;
+	    cout << setw(10) << names[kind] << setw(10) << producers << setw(14) << (long int)( producers * Requests / seconds ) << endl;
+	} // for
+    } // for
+} // main
+
+// Local Variables: //
+// compile-command: "u++-work -O2 -multi ExecutorMailbox.cc" //
+// End: //
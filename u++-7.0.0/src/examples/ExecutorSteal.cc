@@ -0,0 +1,64 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 7.0.0, Copyright (C) Peter A. Buhr 2018
+//
+// ExecutorSteal.cc -- Executor with an unbalanced load, evened out by work stealing.
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// Requests are distributed round-robin over 16 mailboxes served by 4 workers, so worker 0 owns mailboxes 0-3. Only the
+// requests sent to these mailboxes are expensive, so without stealing worker 0 does almost all the work. The elapsed
+// time is compared with the time for a balanced load; with -statistics the steal counters are printed.
+
+#include <iostream>
+using namespace std;
+#include <uFuture.h>
+
+enum { Mailboxes = 16, Workers = 4, Requests = 16000, Work = 20000 };
+
+static volatile unsigned long int sink;
+
+static void work( unsigned int amount ) {
+    unsigned long int sum = 0;
+    for ( unsigned int i = 0; i < amount; i += 1 ) sum += i * i;
+    sink = sum;
+} // work
+
+static long int run( bool balanced ) {
+    uExecutor executor( Mailboxes, Workers, Workers - 1, -1 );
+    uTime start = uThisProcessor().getClock().getTime();
+    Future_ISM< int > *done = new Future_ISM< int >[Requests];
+    for ( unsigned int i = 0; i < Requests; i += 1 ) {	// one sender => tickets are exactly round-robin
+	bool heavy = balanced ? i % Workers == 0 : i % Mailboxes < Mailboxes / Workers;
+	done[i] = executor.sendrecv( [heavy]() { work( heavy ? Work : 0 ); return 0; } );
+    } // for
+    for ( unsigned int i = 0; i < Requests; i += 1 ) done[i]();
+    delete [] done;
+    long int elapsed = ( uThisProcessor().getClock().getTime() - start ).nanoseconds() / 1000000;
+#ifdef __U_STATISTICS__
+    uExecutor::StealStats stats = executor.stealStats();
+    cout << "steal attempts " << stats.attempts << " steals " << stats.steals << " stolen requests " << stats.stolen << endl;
+#endif // __U_STATISTICS__
+    return elapsed;
+} // run
+
+int main() {
+    cout << "balanced " << run( true ) << " ms" << endl;
+    cout << "unbalanced " << run( false ) << " ms" << endl;
+} // main
+
+// Local Variables: //
+// compile-command: "u++-work -O2 -multi ExecutorSteal.cc" //
+// End: //
@@ -0,0 +1,108 @@
+//                              -*- Mode: C++ -*- 
+// 
+// uC++ Version 7.0.0, Copyright (C) Peter A. Buhr 2018
+// 
+// FalseSharing.cc -- Measure the cost of cache lines shared among processors.
+// 
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+// 
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+// 
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+// 
+
+// The first test contrasts counters packed into one cache line with counters padded to uCacheLine(). The second test
+// stresses the hot kernel structures (cluster ready queue and idle list, processor external queue) by having tasks on
+// all processors yield. Cross-processor invalidations (HITM) are best observed with:
+//
+//   perf c2c record ./a.out 4 ; perf c2c report --stdio
+
+#include <iostream>
+using namespace std;
+#include <cstdlib>					// atoi
+
+unsigned int uDefaultPreemption() {
+    return 0;						// no timeslicing to disturb the measurements
+} // uDefaultPreemption
+
+enum { MaxProcessors = 64 };
+const unsigned int Increments = 50000000, Yields = 200000;
+
+struct Packed {
+    volatile unsigned long int cnt;
+} packed[MaxProcessors];
+
+struct Padded {
+    volatile unsigned long int cnt;
+} __attribute__(( aligned (uCacheLine()) )) padded[MaxProcessors];
+
+_Task Counter {
+    volatile unsigned long int &cnt;
+
+    void main() {
+	for ( unsigned int i = 0; i < Increments; i += 1 ) {
+	    cnt += 1;
+	} // for
+    } // Counter::main
+  public:
+    Counter( volatile unsigned long int &cnt ) : cnt( cnt ) {}
+}; // Counter
+
+_Task Yielder {
+    void main() {
+	for ( unsigned int i = 0; i < Yields; i += 1 ) {
+	    yield();
+	} // for
+    } // Yielder::main
+}; // Yielder
+
+template< typename Counters > long long int counters( Counters counts[], unsigned int nprocs ) {
+    uTime start = uThisProcessor().getClock().getTime();
+    {
+	Counter *tasks[MaxProcessors];
+	for ( unsigned int i = 0; i < nprocs; i += 1 ) {
+	    tasks[i] = new Counter( counts[i].cnt );
+	} // for
+	for ( unsigned int i = 0; i < nprocs; i += 1 ) {
+	    delete tasks[i];
+	} // for
+    }
+    return ( uThisProcessor().getClock().getTime() - start ).nanoseconds();
+} // counters
+
+int main( int argc, char *argv[] ) {
+    unsigned int nprocs = 4;
+    if ( argc > 1 ) nprocs = atoi( argv[1] );
+    if ( nprocs < 1 || nprocs > MaxProcessors ) {
+	cerr << "Usage: " << argv[0] << " [ processors (1-" << MaxProcessors << ") ]" << endl;
+	exit( EXIT_FAILURE );
+    } // if
+
+    uProcessor *processors = new uProcessor[nprocs - 1];	// plus the user processor
+
+    long long int packedTime = counters( packed, nprocs );
+    long long int paddedTime = counters( padded, nprocs );
+    cout << nprocs << " processors, counters packed " << packedTime / 1000000 << " ms, padded " << paddedTime / 1000000
+	 << " ms, ratio " << (double)packedTime / paddedTime << endl;
+
+    uTime start = uThisProcessor().getClock().getTime();
+    {
+	Yielder *tasks = new Yielder[nprocs * 2];	// keep every processor busy
+	delete [] tasks;
+    }
+    long long int yieldTime = ( uThisProcessor().getClock().getTime() - start ).nanoseconds();
+    cout << nprocs << " processors, yield " << yieldTime / ( Yields * nprocs * 2 ) << " ns per yield" << endl;
+
+    delete [] processors;
+} // main
+
+// Local Variables: //
+// compile-command: "u++-work -O2 -multi FalseSharing.cc" //
+// End: //
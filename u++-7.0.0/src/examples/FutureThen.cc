@@ -0,0 +1,100 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 7.0.0, Copyright (C) Peter A. Buhr 2018
+//
+// FutureThen.cc -- Request/response chains on an executor with and without continuations.
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// Many chains of Hops requests run concurrently. With blocking, each chain is a task that waits on the future of every
+// hop before sending the next. With continuations, each hop is added with then and runs on the executor when the
+// previous hop is delivered, so only the final result is waited on. The time per hop is reported for both, and an
+// exception raised in a hop is checked to reach the end of a chain.
+
+#include <iostream>
+using namespace std;
+#include <uFuture.h>
+#include <cstdlib>					// atoi
+
+enum { Hops = 100 };
+unsigned int Chains = 1000;
+
+_Event Failed {};
+
+_Task Blocking {						// one blocked task per chain
+    uExecutor &executor;
+
+    void main() {
+	unsigned int value = 0;
+	for ( unsigned int h = 0; h < Hops; h += 1 ) {
+	    value = executor.sendrecv( [value]() { return value + 1; } )();
+	} // for
+	if ( value != Hops ) abort( "blocking chain computed %u", value );
+    } // Blocking::main
+  public:
+    Blocking( uExecutor &executor ) : executor( executor ) {}
+}; // Blocking
+
+static Future_ISM< unsigned int > chain( uExecutor &executor, unsigned int hops ) {
+    Future_ISM< unsigned int > value = executor.sendrecv( []() { return 1u; } );
+    for ( unsigned int h = 1; h < hops; h += 1 ) {
+	value = value.then( executor, []( Future_ISM< unsigned int > prev ) { return prev() + 1; } );
+    } // for
+    return value;
+} // chain
+
+int main( int argc, char *argv[] ) {
+    if ( argc > 1 ) Chains = atoi( argv[1] );
+    if ( Chains < 1 ) {
+	cerr << "Usage: " << argv[0] << " [ chains (> 0) ]" << endl;
+	exit( EXIT_FAILURE );
+    } // if
+    uExecutor executor;
+
+    uTime start = uThisProcessor().getClock().getTime();
+    {
+	Blocking **tasks = new Blocking *[Chains];
+	for ( unsigned int c = 0; c < Chains; c += 1 ) tasks[c] = new Blocking( executor );
+	for ( unsigned int c = 0; c < Chains; c += 1 ) delete tasks[c];
+	delete [] tasks;
+    }
+    uTime end = uThisProcessor().getClock().getTime();
+    cout << "blocking " << ( end - start ).nanoseconds() / ( Chains * Hops ) << " ns/hop" << endl;
+
+    start = uThisProcessor().getClock().getTime();
+    {
+	Future_ISM< unsigned int > *results = new Future_ISM< unsigned int >[Chains];
+	for ( unsigned int c = 0; c < Chains; c += 1 ) results[c] = chain( executor, Hops );
+	for ( unsigned int c = 0; c < Chains; c += 1 ) {
+	    if ( results[c]() != Hops ) abort( "continuation chain computed %u", (unsigned int)results[c] );
+	} // for
+	delete [] results;
+    }
+    end = uThisProcessor().getClock().getTime();
+    cout << "continuation " << ( end - start ).nanoseconds() / ( Chains * Hops ) << " ns/hop" << endl;
+
+    Future_ISM< unsigned int > failed = executor.sendrecv( []() -> unsigned int { _Throw Failed(); } )
+	.then( executor, []( Future_ISM< unsigned int > prev ) { return prev() + 1; } ); // prev() reraises
+    try {
+	failed();
+	abort( "exception not propagated along chain" );
+    } catch( Failed & ) {
+	cout << "exception propagated" << endl;
+    } // try
+} // main
+
+// Local Variables: //
+// compile-command: "u++-work -O2 -multi FutureThen.cc" //
+// End: //
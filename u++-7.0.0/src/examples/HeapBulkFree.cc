@@ -0,0 +1,83 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 7.0.0, Copyright (C) Peter A. Buhr 2018
+//
+// HeapBulkFree.cc -- Compare the cost of free, free_sized and free_bulk.
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// Each task repeatedly allocates a batch of blocks and frees it with free, free_sized, or free_bulk, and the time per
+// block is reported. The batch is larger than a magazine so most frees reach the shared bucket lists.
+
+#include <iostream>
+#include <iomanip>
+using namespace std;
+#include <cstdlib>					// atoi
+#include <malloc.h>					// free_sized, free_bulk
+
+enum { Tasks = 4, Batch = 256, Rounds = 4000 };
+enum Kind { Free, FreeSized, FreeBulk };
+
+_Task Worker {
+    Kind kind;
+    size_t size;
+
+    void main() {
+	void *blocks[Batch];
+	for ( unsigned int r = 0; r < Rounds; r += 1 ) {
+	    for ( unsigned int i = 0; i < Batch; i += 1 ) blocks[i] = malloc( size );
+	    switch ( kind ) {
+	      case Free:
+		for ( unsigned int i = 0; i < Batch; i += 1 ) free( blocks[i] );
+		break;
+	      case FreeSized:
+		for ( unsigned int i = 0; i < Batch; i += 1 ) free_sized( blocks[i], size );
+		break;
+	      case FreeBulk:
+		free_bulk( blocks, Batch );
+		break;
+	    } // switch
+	} // for
+    } // Worker::main
+  public:
+    Worker( Kind kind, size_t size ) : kind( kind ), size( size ) {}
+}; // Worker
+
+int main( int argc, char *argv[] ) {
+    size_t size = 64;
+    if ( argc > 1 ) size = atoi( argv[1] );
+    if ( size < 1 ) {
+	cerr << "Usage: " << argv[0] << " [ block size (> 0) ]" << endl;
+	exit( EXIT_FAILURE );
+    } // if
+
+    uProcessor processors[Tasks - 1];
+    const char *names[] = { "free", "free_sized", "free_bulk" };
+    for ( int kind = Free; kind <= FreeBulk; kind += 1 ) {
+	uTime start = uThisProcessor().getClock().getTime();
+	{
+	    Worker *workers[Tasks];
+	    for ( unsigned int i = 0; i < Tasks; i += 1 ) workers[i] = new Worker( (Kind)kind, size );
+	    for ( unsigned int i = 0; i < Tasks; i += 1 ) delete workers[i];
+	}
+	uTime end = uThisProcessor().getClock().getTime();
+	cout << setw(12) << names[kind] << setw(8)
+	     << ( end - start ).nanoseconds() / ( (long int)Tasks * Batch * Rounds ) << " ns/block" << endl;
+    } // for
+} // main
+
+// Local Variables: //
+// compile-command: "u++-work -O2 -multi HeapBulkFree.cc" //
+// End: //
@@ -0,0 +1,70 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 7.0.0, Copyright (C) Peter A. Buhr 2018
+//
+// HeapHugePages.cc -- Compare random access to heap storage backed by normal and transparent huge pages.
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// For each heap huge-page mode (normal pages, huge pages, pre-faulted huge pages), a large buffer is allocated, filled,
+// and then read at random locations, so most reads miss the TLB with normal pages. The time to allocate and fill the
+// buffer and the time per random read are reported. The heap statistics (-statistics) report the huge-page coverage.
+
+#include <iostream>
+#include <iomanip>
+using namespace std;
+#include <cstdlib>					// atoi
+#include <cstring>					// memset
+#include <malloc.h>					// mallopt
+
+enum { Reads = 20000000 };
+
+int main( int argc, char *argv[] ) {
+    size_t mbytes = 256;
+    if ( argc > 1 ) mbytes = atoi( argv[1] );
+    if ( mbytes < 4 ) {
+	cerr << "Usage: " << argv[0] << " [ buffer size in MB (>= 4) ]" << endl;
+	exit( EXIT_FAILURE );
+    } // if
+    size_t size = mbytes * 1024 * 1024;
+
+    const char *modes[] = { "normal", "huge", "populate" };
+    cout << setw(10) << "mode" << setw(12) << "fill ms" << setw(12) << "read ns" << endl;
+    for ( int mode = 0; mode < 3; mode += 1 ) {
+	if ( mallopt( M_HUGE_PAGES, mode ) != 0 ) abort( "mallopt M_HUGE_PAGES failed" );
+
+	uTime start = uThisProcessor().getClock().getTime();
+	unsigned long int *buffer = (unsigned long int *)malloc( size );
+	memset( buffer, 0, size );
+	uTime filled = uThisProcessor().getClock().getTime();
+
+	size_t elems = size / sizeof(unsigned long int);
+	unsigned long int sum = 0, rand = 42;
+	for ( unsigned int i = 0; i < Reads; i += 1 ) {
+	    rand = rand * 6364136223846793005ul + 1442695040888963407ul; // LCG
+	    sum += buffer[(rand >> 16) % elems];
+	} // for
+	uTime end = uThisProcessor().getClock().getTime();
+	free( buffer );
+
+	cout << setw(10) << modes[mode] << setw(12) << ( filled - start ).nanoseconds() / 1000000
+	     << setw(12) << ( end - filled ).nanoseconds() / Reads << ( sum == 1 ? " " : "" ) << endl;
+    } // for
+    malloc_stats();
+} // main
+
+// Local Variables: //
+// compile-command: "u++-work -O2 -multi HeapHugePages.cc" //
+// End: //
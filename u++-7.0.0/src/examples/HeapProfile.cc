@@ -0,0 +1,86 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 7.0.0, Copyright (C) Peter A. Buhr 2018
+//
+// HeapProfile.cc -- Sampling heap profile of a program with a memory hog.
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// Several tasks allocate from two sites: one keeps its blocks (the hog) and the other frees them immediately. The
+// profile written to HeapProfile.prof attributes nearly all live bytes to the hog, and can be examined with:
+//
+//   pprof --text ./a.out HeapProfile.prof
+//
+// The profile can also be written from a running program by sending it the signal selected with M_PROFILE_SIGNAL; the
+// file is written at the next sampled allocation.
+
+#include <iostream>
+using namespace std;
+#include <malloc.h>					// mallopt, malloc_profile
+#include <fcntl.h>					// open
+#include <unistd.h>					// close
+
+enum { Tasks = 4, Allocs = 20000 };
+
+void * __attribute__(( noinline )) hog( size_t size ) {
+    return malloc( size );
+} // hog
+
+void * __attribute__(( noinline )) transient( size_t size ) {
+    return malloc( size );
+} // transient
+
+void **kept[Tasks];					// hog blocks kept live until the profile is written
+
+_Task Worker {
+    unsigned int id;
+
+    void main() {
+	kept[id] = new void *[Allocs];
+	for ( unsigned int i = 0; i < Allocs; i += 1 ) {
+	    kept[id][i] = hog( 512 + i % 1024 );
+	    free( transient( 4096 ) );
+	} // for
+	for ( unsigned int i = 0; i < Allocs; i += 2 ) {	// release half of the hog's storage
+	    free( kept[id][i] );
+	} // for
+    } // Worker::main
+  public:
+    Worker( unsigned int id ) : id( id ) {}
+}; // Worker
+
+int main() {
+    if ( mallopt( M_SAMPLE_RATE, 64 * 1024 ) != 0 ) abort( "mallopt M_SAMPLE_RATE failed" ); // dense sampling for a short run
+    mallopt( M_PROFILE_SIGNAL, SIGUSR2 );
+    {
+	uProcessor processors[Tasks - 1];
+	Worker *workers[Tasks];
+	for ( unsigned int i = 0; i < Tasks; i += 1 ) workers[i] = new Worker( i );
+	for ( unsigned int i = 0; i < Tasks; i += 1 ) delete workers[i];
+    }
+    int fd = open( "HeapProfile.prof", O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+    if ( fd == -1 || malloc_profile( fd ) != 0 ) abort( "cannot write heap profile" );
+    close( fd );
+    cout << "heap profile written to HeapProfile.prof" << endl;
+
+    for ( unsigned int id = 0; id < Tasks; id += 1 ) {
+	for ( unsigned int i = 1; i < Allocs; i += 2 ) free( kept[id][i] );
+	delete [] kept[id];
+    } // for
+} // main
+
+// Local Variables: //
+// compile-command: "u++-work -O2 -multi HeapProfile.cc" //
+// End: //
@@ -0,0 +1,87 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 7.0.0, Copyright (C) Peter A. Buhr 2018
+//
+// HeapPurge.cc -- Show resident memory returning to the OS after an allocation spike.
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// A spike allocates and touches many medium-sized blocks and frees them. The resident set size is reported after the
+// spike, after the system task purges the unused buckets (decay shortened with mallopt), and after malloc_trim. The
+// time of a steady-state malloc/free loop is reported with purging on and off to show it is not slowed down.
+
+#include <iostream>
+#include <iomanip>
+using namespace std;
+#include <cstdlib>					// atoi
+#include <cstring>					// memset
+#include <malloc.h>					// mallopt, malloc_trim
+#include <unistd.h>					// sysconf
+
+enum { BlockSize = 64 * 1024, Steady = 1000000 };
+
+static long int rss() {					// resident set size in KB
+    long int size, resident;
+    FILE *statm = fopen( "/proc/self/statm", "r" );
+    if ( statm == nullptr ) return -1;
+    if ( fscanf( statm, "%ld %ld", &size, &resident ) != 2 ) resident = -1;
+    fclose( statm );
+    return resident * ( sysconf( _SC_PAGESIZE ) / 1024 );
+} // rss
+
+static long int steady() {				// nanoseconds per malloc/free pair
+    uTime start = uThisProcessor().getClock().getTime();
+    for ( unsigned int i = 0; i < Steady; i += 1 ) {
+	void *volatile p = malloc( BlockSize );
+	free( p );
+    } // for
+    return ( uThisProcessor().getClock().getTime() - start ).nanoseconds() / Steady;
+} // steady
+
+int main( int argc, char *argv[] ) {
+    unsigned int blocks = 4096;				// 256 MB spike
+    if ( argc > 1 ) blocks = atoi( argv[1] );
+    if ( blocks < 1 ) {
+	cerr << "Usage: " << argv[0] << " [ spike blocks of " << BlockSize << " bytes (> 0) ]" << endl;
+	exit( EXIT_FAILURE );
+    } // if
+
+    cout << "start RSS " << rss() << " KB" << endl;
+    char **spike = new char *[blocks];
+    for ( unsigned int i = 0; i < blocks; i += 1 ) {
+	spike[i] = (char *)malloc( BlockSize );
+	memset( spike[i], 'x', BlockSize );		// make pages resident
+    } // for
+    cout << "spike RSS " << rss() << " KB" << endl;
+    for ( unsigned int i = 0; i < blocks; i += 1 ) {
+	free( spike[i] );
+    } // for
+    delete [] spike;
+    cout << "freed RSS " << rss() << " KB" << endl;
+
+    mallopt( M_PURGE_DECAY, 100 );			// 100 milliseconds
+    uThisTask().sleep( uDuration( 0, 500000000 ) );	// bucket must be unused for a full interval
+    cout << "decayed RSS " << rss() << " KB" << endl;
+    malloc_trim( 0 );
+    cout << "trimmed RSS " << rss() << " KB" << endl;
+
+    cout << "steady state, purging on " << steady() << " ns";
+    mallopt( M_PURGE_DECAY, 0 );
+    cout << ", purging off " << steady() << " ns" << endl;
+} // main
+
+// Local Variables: //
+// compile-command: "u++-work -O2 -multi HeapPurge.cc" //
+// End: //
@@ -0,0 +1,107 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 7.0.0, Copyright (C) Peter A. Buhr 2018
+//
+// MigrateBatch.cc -- Tasks migrating between an I/O cluster and a compute cluster.
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// Each request task starts on the I/O cluster, migrates to the compute cluster to do some work, and migrates back, as a
+// server splitting blocking I/O from computation does. Many tasks migrate at once, so tasks bound for the same cluster
+// arrive in batches. The time per request and each cluster's histogram of the time migrating tasks wait to be taken
+// by one of its processors are reported.
+
+#include <iostream>
+#include <iomanip>
+using namespace std;
+#include <cstdlib>					// atoi
+
+uCluster ioCluster( "io" ), computeCluster( "compute" );
+
+_Task Request {
+    unsigned int requests;
+
+    void main() {
+	volatile unsigned long int sum = 0;
+	for ( unsigned int r = 0; r < requests; r += 1 ) {
+	    migrate( computeCluster );
+	    for ( unsigned int i = 0; i < 2000; i += 1 ) sum += i; // compute
+	    migrate( ioCluster );
+	} // for
+    } // Request::main
+  public:
+    Request( unsigned int requests ) : uBaseTask( ioCluster ), requests( requests ) {}
+}; // Request
+
+static void histogram( uCluster &cluster ) {
+    unsigned int counts[uCluster::MigrationBuckets];
+    cluster.getMigrationLatency( counts );
+    cout << cluster.getName() << " cluster inbox latency (us)" << endl;
+    for ( unsigned int b = 0; b < uCluster::MigrationBuckets; b += 1 ) {
+      if ( counts[b] == 0 ) continue;
+	cout << setw(8) << ( b == 0 ? 0 : 1u << ( b - 1 ) ) << " - ";
+	if ( b == uCluster::MigrationBuckets - 1 ) cout << setw(6) << "";
+	else cout << setw(6) << ( 1u << b );
+	cout << setw(10) << counts[b] << endl;
+    } // for
+} // histogram
+
+int main( int argc, char *argv[] ) {
+    unsigned int procs = 2, tasks = 64, requests = 1000;
+    switch ( argc ) {
+      case 4: requests = atoi( argv[3] );
+      case 3: tasks = atoi( argv[2] );
+      case 2: procs = atoi( argv[1] );
+      case 1: break;
+      default:
+	cerr << "Usage: " << argv[0] << " [ processors per cluster [ tasks [ requests per task ] ] ]" << endl;
+	exit( EXIT_FAILURE );
+    } // switch
+    if ( procs == 0 || tasks == 0 || requests == 0 ) {
+	cerr << "Usage: " << argv[0] << " [ processors per cluster (> 0) [ tasks (> 0) [ requests per task (> 0) ] ] ]" << endl;
+	exit( EXIT_FAILURE );
+    } // if
+
+    uTime start = uThisProcessor().getClock().getTime();
+    {
+	uProcessor **io = new uProcessor *[procs], **compute = new uProcessor *[procs];
+	for ( unsigned int p = 0; p < procs; p += 1 ) {
+	    io[p] = new uProcessor( ioCluster );
+	    compute[p] = new uProcessor( computeCluster );
+	} // for
+	{
+	    Request **workers = new Request *[tasks];
+	    for ( unsigned int t = 0; t < tasks; t += 1 ) workers[t] = new Request( requests );
+	    for ( unsigned int t = 0; t < tasks; t += 1 ) delete workers[t];
+	    delete [] workers;
+	}
+	for ( unsigned int p = 0; p < procs; p += 1 ) {
+	    delete io[p];
+	    delete compute[p];
+	} // for
+	delete [] io;
+	delete [] compute;
+    }
+    uTime end = uThisProcessor().getClock().getTime();
+
+    cout << "requests " << tasks * requests << ", " << ( end - start ).nanoseconds() / ( (long long int)tasks * requests )
+	 << " ns per request (2 migrations)" << endl;
+    histogram( computeCluster );
+    histogram( ioCluster );
+} // main
+
+// Local Variables: //
+// compile-command: "u++-work -O2 -multi MigrateBatch.cc" //
+// End: //
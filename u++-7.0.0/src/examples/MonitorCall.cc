@@ -0,0 +1,156 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 7.0.0, Copyright (C) Peter A. Buhr 2018
+//
+// MonitorCall.cc -- Cost of mutex-member calls with and without contention.
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// For 1, 2, 4, ... up to the given number of processors, one task per processor calls a mutex member of its own
+// monitor (uncontended), a mutex member that recursively calls another (nested), and a mutex member of a monitor shared
+// by all tasks (contended). The time per call is reported for each case. Uncontended and nested calls take the
+// single compare-and-swap entry, so their cost should stay flat as processors are added. A bounded buffer using
+// _Accept is then run to check accepting still works on a monitor whose members were called through the fast path.
+
+#include <iostream>
+#include <iomanip>
+using namespace std;
+#include <cstdlib>					// atoi
+
+unsigned int uDefaultPreemption() {
+    return 0;						// no timeslicing to disturb the measurements
+} // uDefaultPreemption
+
+enum { MaxProcessors = 64, Items = 100000 };
+unsigned int Calls = 5000000;
+
+_Monitor Counter {
+    unsigned long int cnt = 0;
+  public:
+    void inc() { cnt += 1; }
+    void incNested() { inc(); }				// recursive entry
+    unsigned long int count() { return cnt; }
+}; // Counter
+
+_Monitor Buffer {					// accept after fast-path calls
+    enum { Size = 10 };
+    int elems[Size];
+    unsigned int front = 0, back = 0, count = 0;
+  public:
+    _Nomutex unsigned int query() { return count; }
+
+    void insert( int elem ) {
+	if ( count == Size ) _Accept( remove );
+	elems[back] = elem;
+	back = ( back + 1 ) % Size;
+	count += 1;
+    } // Buffer::insert
+
+    int remove() {
+	if ( count == 0 ) _Accept( insert );
+	int elem = elems[front];
+	front = ( front + 1 ) % Size;
+	count -= 1;
+	return elem;
+    } // Buffer::remove
+}; // Buffer
+
+enum Kind { Uncontended, Nested, Contended };
+
+_Task Caller {
+    Counter &counter;
+    Kind kind;
+
+    void main() {
+	switch ( kind ) {
+	  case Uncontended:
+	  case Contended:
+	    for ( unsigned int i = 0; i < Calls; i += 1 ) counter.inc();
+	    break;
+	  case Nested:
+	    for ( unsigned int i = 0; i < Calls; i += 1 ) counter.incNested();
+	    break;
+	} // switch
+    } // Caller::main
+  public:
+    Caller( Counter &counter, Kind kind ) : counter( counter ), kind( kind ) {}
+}; // Caller
+
+_Task Producer {
+    Buffer &buffer;
+
+    void main() {
+	for ( int i = 1; i <= Items; i += 1 ) buffer.insert( i );
+    } // Producer::main
+  public:
+    Producer( Buffer &buffer ) : buffer( buffer ) {}
+}; // Producer
+
+static double run( unsigned int procs, Kind kind ) {	// nanoseconds per call
+    Counter shared, *counters = new Counter[procs];
+    Caller *callers[MaxProcessors];
+    uTime start = uThisProcessor().getClock().getTime();
+    for ( unsigned int i = 0; i < procs; i += 1 ) {
+	callers[i] = new Caller( kind == Contended ? shared : counters[i], kind );
+    } // for
+    for ( unsigned int i = 0; i < procs; i += 1 ) delete callers[i];
+    uTime end = uThisProcessor().getClock().getTime();
+
+    unsigned long int total = shared.count();
+    for ( unsigned int i = 0; i < procs; i += 1 ) total += counters[i].count();
+    delete [] counters;
+    if ( total != (unsigned long int)procs * Calls ) abort( "lost increments %lu", total );
+    return (double)( end - start ).nanoseconds() / Calls;
+} // run
+
+int main( int argc, char *argv[] ) {
+    unsigned int maxProcs = 4;
+    switch ( argc ) {
+      case 3:
+	Calls = atoi( argv[2] );
+      case 2:
+	maxProcs = atoi( argv[1] );
+      case 1:
+	break;
+      default:
+	cerr << "Usage: " << argv[0] << " [ processors (> 0) [ calls (> 0) ] ]" << endl;
+	exit( EXIT_FAILURE );
+    } // switch
+    if ( maxProcs < 1 || maxProcs > MaxProcessors || Calls < 1 ) {
+	cerr << "Usage: " << argv[0] << " [ processors (1-" << MaxProcessors << ") [ calls (> 0) ] ]" << endl;
+	exit( EXIT_FAILURE );
+    } // if
+
+    cout << setw(6) << "procs" << setw(14) << "uncontended" << setw(10) << "nested" << setw(12) << "contended" << "  (ns/call)" << endl;
+    cout << setprecision(1) << fixed;
+    for ( unsigned int procs = 1; procs <= maxProcs; procs *= 2 ) {
+	uProcessor *processors = new uProcessor[procs - 1];
+	cout << setw(6) << procs << setw(14) << run( procs, Uncontended ) << setw(10) << run( procs, Nested )
+	     << setw(12) << run( procs, Contended ) << endl;
+	delete [] processors;
+    } // for
+
+    Buffer buffer;
+    long int sum = 0;
+    {
+	Producer producer( buffer );
+	for ( int i = 1; i <= Items; i += 1 ) sum += buffer.remove();
+    }
+    if ( sum != (long int)Items * ( Items + 1 ) / 2 || buffer.query() != 0 ) abort( "bounded buffer lost elements" );
+} // main
+
+// Local Variables: //
+// compile-command: "u++-work -O2 -multi MonitorCall.cc" //
+// End: //
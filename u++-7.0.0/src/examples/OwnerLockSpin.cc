@@ -0,0 +1,108 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 7.0.0, Copyright (C) Peter A. Buhr 2018
+//
+// OwnerLockSpin.cc -- Compare the spin-then-block uOwnerLock with a lock that always blocks.
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// One task per processor repeatedly acquires a shared lock, runs a critical section and releases the lock. The lock is
+// a uOwnerLock, which spins while the owner is running on another processor, or a binary semaphore, which always blocks
+// when the lock is held. For a short critical section, spinning avoids a block and wake per acquire, so uOwnerLock
+// should be faster; for a long one, the adaptive budget shrinks and both cost about the same. The time per critical
+// section is reported, and -statistics reports how many owner-lock acquires spun and how many blocked.
+
+#include <iostream>
+#include <iomanip>
+using namespace std;
+#include <cstdlib>					// atoi
+#include <uSemaphore.h>
+
+unsigned int uDefaultPreemption() {
+    return 0;						// no timeslicing to disturb the measurements
+} // uDefaultPreemption
+
+unsigned int Passes = 200000;
+
+static void work( unsigned int length ) {		// critical section
+    for ( volatile unsigned int i = 0; i < length; i += 1 );
+} // work
+
+uOwnerLock ownerLock;
+uSemaphore blockLock( 1 );
+
+_Task Worker {
+    bool owner;
+    unsigned int length;
+
+    void main() {
+	for ( unsigned int p = 0; p < Passes; p += 1 ) {
+	    if ( owner ) {
+		ownerLock.acquire();
+		work( length );
+		ownerLock.release();
+	    } else {
+		blockLock.P();
+		work( length );
+		blockLock.V();
+	    } // if
+	    work( length );				// outside the lock
+	} // for
+    } // Worker::main
+  public:
+    Worker( bool owner, unsigned int length ) : owner( owner ), length( length ) {}
+}; // Worker
+
+static long long int run( unsigned int procs, bool owner, unsigned int length ) {
+    uTime start = uThisProcessor().getClock().getTime();
+    {
+	Worker **workers = new Worker *[procs];
+	for ( unsigned int w = 0; w < procs; w += 1 ) workers[w] = new Worker( owner, length );
+	for ( unsigned int w = 0; w < procs; w += 1 ) delete workers[w];
+	delete [] workers;
+    }
+    uTime end = uThisProcessor().getClock().getTime();
+    return ( end - start ).nanoseconds() / ( (long long int)procs * Passes );
+} // run
+
+int main( int argc, char *argv[] ) {
+    unsigned int procs = 4;
+    switch ( argc ) {
+      case 3: Passes = atoi( argv[2] );
+      case 2: procs = atoi( argv[1] );
+      case 1: break;
+      default:
+	cerr << "Usage: " << argv[0] << " [ processors [ passes ] ]" << endl;
+	exit( EXIT_FAILURE );
+    } // switch
+    if ( procs == 0 || Passes == 0 ) {
+	cerr << "Usage: " << argv[0] << " [ processors (> 0) [ passes (> 0) ] ]" << endl;
+	exit( EXIT_FAILURE );
+    } // if
+
+    uProcessor *processors = new uProcessor[procs - 1];	// plus the main processor
+    unsigned int lengths[] = { 20, 200, 20000 };
+    cout << setw(10) << "section" << setw(14) << "owner ns" << setw(14) << "blocking ns" << endl;
+    for ( unsigned int length : lengths ) {
+	long long int spin = run( procs, true, length );
+	long long int block = run( procs, false, length );
+	cout << setw(10) << length << setw(14) << spin << setw(14) << block << endl;
+    } // for
+    delete [] processors;
+} // main
+
+// Local Variables: //
+// compile-command: "u++-work -O2 -multi OwnerLockSpin.cc" //
+// End: //
@@ -0,0 +1,121 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 7.0.0, Copyright (C) Peter A. Buhr 2018
+//
+// Parallel.cc -- Parallel algorithms compared with the sequential standard algorithms.
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// Each algorithm in uParallel.h runs on a cluster with the given number of processors and then its sequential standard
+// counterpart runs on the same data. The results are compared and the times and speedup are reported.
+
+#include <iostream>
+#include <iomanip>
+using namespace std;
+#include <cstdlib>					// atoi
+#include <cmath>					// sqrt
+#include <numeric>					// accumulate, partial_sum
+#include <uParallel.h>
+
+static long int elapsed( uTime start ) {		// microseconds
+    return ( uThisProcessor().getClock().getTime() - start ).nanoseconds() / 1000;
+} // elapsed
+
+static void report( const char *name, long int par, long int seq ) {
+    cout << setw(18) << name << setw(12) << par << setw(12) << seq << setw(10) << (double)seq / ( par > 0 ? par : 1 ) << endl;
+} // report
+
+int main( int argc, char *argv[] ) {
+    unsigned int procs = 4, size = 10000000;
+    switch ( argc ) {
+      case 3:
+	size = atoi( argv[2] );
+      case 2:
+	procs = atoi( argv[1] );
+      case 1:
+	break;
+      default:
+	procs = 0;
+    } // switch
+    if ( procs < 1 || size < 1 ) {
+	cerr << "Usage: " << argv[0] << " [ processors (> 0) [ elements (> 0) ] ]" << endl;
+	exit( EXIT_FAILURE );
+    } // if
+    uProcessor *processors = new uProcessor[procs - 1];
+
+    vector<double> data( size ), par( size ), seq( size );
+    for ( unsigned int i = 0; i < size; i += 1 ) data[i] = ( i * 2654435761u ) % 1000003; // scrambled values
+    cout << setprecision(2) << fixed;
+    cout << setw(18) << "algorithm" << setw(12) << "parallel us" << setw(12) << "seq us" << setw(10) << "speedup" << endl;
+
+    uTime start = uThisProcessor().getClock().getTime();
+    uParallel::transform( data.begin(), data.end(), par.begin(), []( double d ) { return sqrt( d ); } );
+    long int p = elapsed( start );
+    start = uThisProcessor().getClock().getTime();
+    transform( data.begin(), data.end(), seq.begin(), []( double d ) { return sqrt( d ); } );
+    report( "transform", p, elapsed( start ) );
+    if ( par != seq ) abort( "transform differs" );
+
+    start = uThisProcessor().getClock().getTime();
+    uParallel::for_each( par.begin(), par.end(), []( double &d ) { d = d * d; } );
+    p = elapsed( start );
+    start = uThisProcessor().getClock().getTime();
+    for_each( seq.begin(), seq.end(), []( double &d ) { d = d * d; } );
+    report( "for_each", p, elapsed( start ) );
+    if ( par != seq ) abort( "for_each differs" );
+
+    start = uThisProcessor().getClock().getTime();
+    long int psum = uParallel::reduce( data.begin(), data.end(), 0L, []( long int x, long int y ) { return x + y; } );
+    p = elapsed( start );
+    start = uThisProcessor().getClock().getTime();
+    long int ssum = accumulate( data.begin(), data.end(), 0L );
+    report( "reduce", p, elapsed( start ) );
+    if ( psum != ssum ) abort( "reduce differs" );
+
+    start = uThisProcessor().getClock().getTime();
+    double pmax = uParallel::transform_reduce( data.begin(), data.end(), 0.0,
+					       []( double x, double y ) { return x > y ? x : y; }, []( double d ) { return sqrt( d ); } );
+    p = elapsed( start );
+    start = uThisProcessor().getClock().getTime();
+    double smax = 0.0;
+    for ( double d : data ) smax = max( smax, sqrt( d ) );
+    report( "transform_reduce", p, elapsed( start ) );
+    if ( pmax != smax ) abort( "transform_reduce differs" );
+
+    vector<long int> ldata( data.begin(), data.end() ), lpar( size ), lseq( size );
+    start = uThisProcessor().getClock().getTime();
+    uParallel::inclusive_scan( ldata.begin(), ldata.end(), lpar.begin(), []( long int x, long int y ) { return x + y; } );
+    p = elapsed( start );
+    start = uThisProcessor().getClock().getTime();
+    partial_sum( ldata.begin(), ldata.end(), lseq.begin() );
+    report( "inclusive_scan", p, elapsed( start ) );
+    if ( lpar != lseq ) abort( "inclusive_scan differs" );
+
+    par = data;
+    seq = data;
+    start = uThisProcessor().getClock().getTime();
+    uParallel::sort( par.begin(), par.end() );
+    p = elapsed( start );
+    start = uThisProcessor().getClock().getTime();
+    sort( seq.begin(), seq.end() );
+    report( "sort", p, elapsed( start ) );
+    if ( par != seq ) abort( "sort differs" );
+
+    delete [] processors;
+} // main
+
+// Local Variables: //
+// compile-command: "u++-work -O2 -multi Parallel.cc" //
+// End: //
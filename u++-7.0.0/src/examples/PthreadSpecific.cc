@@ -0,0 +1,84 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 7.0.0, Copyright (C) Peter A. Buhr 2018
+//
+// PthreadSpecific.cc -- Cost of pthread_getspecific/pthread_setspecific as processors are added.
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// One task per processor repeatedly sets and gets its values for a few keys. Thread specific data is private to each
+// task, so the time per call should stay flat as processors are added. A key is also deleted and recreated while the
+// tasks run to check a task never sees a value set under the old key.
+
+#include <iostream>
+#include <iomanip>
+using namespace std;
+#include <cstdlib>					// atoi
+#include <pthread.h>
+
+enum { Keys = 4, MaxProcs = 8 };
+
+unsigned int Times = 2000000;
+pthread_key_t keys[Keys];
+
+_Task Worker {
+    void main() {
+	long int mine[Keys];
+	for ( unsigned int i = 0; i < Times; i += 1 ) {
+	    pthread_key_t key = keys[i % Keys];
+	    if ( pthread_setspecific( key, &mine[i % Keys] ) != 0 ) abort( "pthread_setspecific failed" );
+	    void *value = pthread_getspecific( key );
+	    if ( value != &mine[i % Keys] ) abort( "pthread_getspecific returned %p instead of %p", value, &mine[i % Keys] );
+	} // for
+    } // Worker::main
+}; // Worker
+
+static void destructor( void * ) {}
+
+int main( int argc, char *argv[] ) {
+    if ( argc > 1 ) Times = atoi( argv[1] );
+    if ( Times < 1 ) {
+	cerr << "Usage: " << argv[0] << " [ calls per task (> 0) ]" << endl;
+	exit( EXIT_FAILURE );
+    } // if
+    for ( unsigned int k = 0; k < Keys; k += 1 ) {
+	if ( pthread_key_create( &keys[k], destructor ) != 0 ) abort( "pthread_key_create failed" );
+    } // for
+
+    // Values set before a key is deleted are not visible through the recreated key.
+    int value;
+    pthread_setspecific( keys[0], &value );
+    pthread_key_delete( keys[0] );
+    pthread_key_create( &keys[0], destructor );
+    if ( pthread_getspecific( keys[0] ) != nullptr ) abort( "value of deleted key visible" );
+
+    cout << setw(6) << "procs" << setw(12) << "ns/call" << endl;
+    for ( unsigned int procs = 1; procs <= MaxProcs; procs *= 2 ) {
+	uProcessor *processors = new uProcessor[procs - 1];
+	uTime start = uThisProcessor().getClock().getTime();
+	Worker *workers = new Worker[procs];
+	delete [] workers;				// wait for workers
+	uTime end = uThisProcessor().getClock().getTime();
+	delete [] processors;
+	cout << setw(6) << procs << setw(12) << setprecision(3) << fixed
+	     << (double)( end - start ).nanoseconds() / Times / 2 << endl; // get + set per iteration
+    } // for
+
+    for ( unsigned int k = 0; k < Keys; k += 1 ) pthread_key_delete( keys[k] );
+} // main
+
+// Local Variables: //
+// compile-command: "u++-work -O2 -multi PthreadSpecific.cc" //
+// End: //
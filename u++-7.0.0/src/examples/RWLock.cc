@@ -24,56 +24,86 @@
 // along  with this library.
 // 
 
+// For 1, 2, 4, ... up to the given number of processors, one reader task per processor repeatedly acquires the read
+// lock while a few writers occasionally acquire the write lock. The time per read acquisition is reported, which
+// should stay nearly flat as processors are added because readers use per-slot indicators instead of a shared count.
+// Readers and writers check they never overlap.
+
 #include <uC++.h>
 #include <uRWLock.h>
 #include <iostream>
+#include <iomanip>
 using namespace std;
+#include <cstdlib>					// atoi
 
 const unsigned int NoOfTimes = 100000;
 const unsigned int Work = 100;
+const unsigned int WriteRatio = 100;			// reads per write
 
 uRWLock rwlock;
+volatile unsigned int writing = 0;			// writers in critical section
 
 _Task Reader {
     void main() {
 	for ( unsigned int i = 0; i < NoOfTimes; i += 1 ) {
 	    rwlock.rdacquire();
-	    // if ( rwlock.wrcnt() != 0 )
-	    // 	abort( "reader interference: wcnt %d, rcnt %d", rwlock.wrcnt(), rwlock.rdcnt() );
+	    if ( writing != 0 ) abort( "reader interference: writers %u", writing );
 	    for ( volatile unsigned int b = 0; b < Work; b += 1 );
-		// if ( rwlock.wrcnt() != 0 )
-		//     abort( "reader interference: wcnt %d, rcnt %d", rwlock.wrcnt(), rwlock.rdcnt() );
+	    if ( writing != 0 ) abort( "reader interference: writers %u", writing );
 	    rwlock.rdrelease();
 	} // for
     } // main
   public:
-};
+}; // Reader
 
 _Task Writer {
     void main() {
-	for ( unsigned int i = 0; i < NoOfTimes; i += 1 ) {
-	    for ( volatile unsigned int b = 0; b < Work; b += 1 );
+	for ( unsigned int i = 0; i < NoOfTimes / WriteRatio; i += 1 ) {
+	    for ( volatile unsigned int b = 0; b < Work * WriteRatio; b += 1 );
 	    rwlock.wracquire();
-	    // if ( rwlock.wrcnt() != 1 || rwlock.rdcnt() != 0 )
-	    // 	abort( "writer interference: wcnt %d, rcnt %d", rwlock.wrcnt(), rwlock.rdcnt() );
+	    writing += 1;
+	    if ( writing != 1 ) abort( "writer interference: writers %u", writing );
 	    for ( volatile unsigned int b = 0; b < Work; b += 1 );
-		// if ( rwlock.wrcnt() != 1 || rwlock.rdcnt() != 0 )
-		//     abort( "writer interference: wcnt %d, rcnt %d", rwlock.wrcnt(), rwlock.rdcnt() );
+	    writing -= 1;
 	    rwlock.wrrelease();
-	    for ( volatile unsigned int b = 0; b < Work; b += 1 );
 	} // for
     } // main
   public:
 }; // Writer
 
 
-int main() {
-    enum { NoOfReaders = 6, NoOfWriters = 2 };
-    uProcessor p[8];
-    {
-	Writer writers[NoOfWriters];
-	Reader readers[NoOfReaders];
-    }
+int main( int argc, char *argv[] ) {
+    unsigned int maxProcs = 8, noOfWriters = 2;
+    switch ( argc ) {
+      case 3:
+	noOfWriters = atoi( argv[2] );
+      case 2:
+	maxProcs = atoi( argv[1] );
+      case 1:
+	break;
+      default:
+	cerr << "Usage: " << argv[0] << " [ processors (> 0) [ writers (>= 0) ] ]" << endl;
+	exit( EXIT_FAILURE );
+    } // switch
+    if ( maxProcs < 1 ) {
+	cerr << "Usage: " << argv[0] << " [ processors (> 0) [ writers (>= 0) ] ]" << endl;
+	exit( EXIT_FAILURE );
+    } // if
+
+    cout << setw(6) << "procs" << setw(14) << "ns/read" << endl;
+    for ( unsigned int procs = 1; procs <= maxProcs; procs *= 2 ) {
+	uProcessor *processors = new uProcessor[procs - 1];
+	uTime start = uThisProcessor().getClock().getTime();
+	{
+	    Writer *writers = new Writer[noOfWriters];
+	    Reader *readers = new Reader[procs];
+	    delete [] readers;
+	    delete [] writers;
+	}
+	uTime end = uThisProcessor().getClock().getTime();
+	delete [] processors;
+	cout << setw(6) << procs << setw(14) << ( end - start ).nanoseconds() / NoOfTimes << endl;
+    } // for
     cout << "successful completion" << endl;
 } // main
 
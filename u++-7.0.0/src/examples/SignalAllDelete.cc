@@ -0,0 +1,94 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 7.0.0, Copyright (C) Peter A. Buhr 2018
+//
+// SignalAllDelete.cc -- Delete a monitor right after uCondition::signalAll restarts its waiting tasks.
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// Tasks wait on a condition of a monitor, which is deleted immediately after the waiting tasks are restarted with
+// signalAll. Like signalled tasks, the restarted tasks must regain the monitor and leave it before the destructor runs,
+// so the destructor checks every waiting task returned.
+
+#include <iostream>
+using namespace std;
+#include <cstdlib>					// atoi
+
+_Monitor Gate {
+    uCondition opened;
+    unsigned int arrived = 0, left = 0;
+  public:
+    void pass() {
+	arrived += 1;
+	opened.wait();
+	left += 1;
+    } // Gate::pass
+
+    unsigned int waiting() {
+	return arrived;
+    } // Gate::waiting
+
+    void open() {
+	opened.signalAll();
+    } // Gate::open
+
+    ~Gate() {
+	if ( left != arrived ) abort( "Gate deleted with %u of %u restarted tasks still inside", arrived - left, arrived );
+    } // Gate::~Gate
+}; // Gate
+
+_Task Walker {
+    Gate &gate;
+
+    void main() {
+	gate.pass();
+    } // Walker::main
+  public:
+    Walker( Gate &gate ) : gate( gate ) {}
+}; // Walker
+
+int main( int argc, char *argv[] ) {
+    unsigned int procs = 4, tasks = 32, rounds = 1000;
+    switch ( argc ) {
+      case 3: tasks = atoi( argv[2] );
+      case 2: procs = atoi( argv[1] );
+      case 1: break;
+      default:
+	cerr << "Usage: " << argv[0] << " [ processors [ tasks ] ]" << endl;
+	exit( EXIT_FAILURE );
+    } // switch
+    if ( procs == 0 || tasks == 0 ) {
+	cerr << "Usage: " << argv[0] << " [ processors (> 0) [ tasks (> 0) ] ]" << endl;
+	exit( EXIT_FAILURE );
+    } // if
+
+    uProcessor *processors = new uProcessor[procs - 1];	// plus the main processor
+    for ( unsigned int r = 0; r < rounds; r += 1 ) {
+	Gate *gate = new Gate;
+	Walker **walkers = new Walker *[tasks];
+	for ( unsigned int t = 0; t < tasks; t += 1 ) walkers[t] = new Walker( *gate );
+	while ( gate->waiting() != tasks ) uBaseTask::yield(); // all tasks waiting ?
+	gate->open();
+	delete gate;					// restarted tasks leave first
+	for ( unsigned int t = 0; t < tasks; t += 1 ) delete walkers[t];
+	delete [] walkers;
+    } // for
+    delete [] processors;
+    cout << "successful completion" << endl;
+} // main
+
+// Local Variables: //
+// compile-command: "u++-work -O2 -multi SignalAllDelete.cc" //
+// End: //
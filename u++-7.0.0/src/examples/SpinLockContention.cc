@@ -0,0 +1,121 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 7.0.0, Copyright (C) Peter A. Buhr 2018
+//
+// SpinLockContention.cc -- Compare test-and-set and queue spin locks under contention.
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// One task per processor repeatedly acquires a shared lock for a short critical section for a fixed period. For 1, 2,
+// 4, ... up to the given number of processors, the test reports the lock throughput and the fairness, i.e., the
+// fewest acquisitions by a task divided by the most (1.0 is perfectly fair).  The last column times yields, which
+// contend on the cluster ready-queue lock selected by the QUEUELOCK build option.
+
+#include <iostream>
+#include <iomanip>
+using namespace std;
+#include <cstdlib>					// atoi
+
+unsigned int uDefaultPreemption() {
+    return 0;						// no timeslicing to disturb the measurements
+} // uDefaultPreemption
+
+enum { MaxProcessors = 64 };
+const uDuration Period( 0, 500000000 );			// 0.5 seconds per measurement
+const unsigned int Yields = 100000;
+
+volatile bool stop;
+volatile unsigned long int shared;			// protected by the lock under test
+
+template< typename Lock > _Task Contender {
+    Lock &lock;
+    unsigned long int &acquisitions;
+
+    void main() {
+	unsigned long int cnt = 0;
+	while ( ! stop ) {
+	    lock.acquire();
+	    shared += 1;				// critical section
+	    lock.release();
+	    cnt += 1;
+	} // while
+	acquisitions = cnt;
+    } // Contender::main
+  public:
+    Contender( Lock &lock, unsigned long int &acquisitions ) : lock( lock ), acquisitions( acquisitions ) {}
+}; // Contender
+
+_Task Yielder {
+    void main() {
+	for ( unsigned int i = 0; i < Yields; i += 1 ) {
+	    yield();
+	} // for
+    } // Yielder::main
+}; // Yielder
+
+template< typename Lock > void contend( unsigned int ntasks ) {
+    Lock lock;
+    unsigned long int acquisitions[MaxProcessors];
+    Contender<Lock> *tasks[MaxProcessors];
+
+    stop = false;
+    for ( unsigned int i = 0; i < ntasks; i += 1 ) {
+	tasks[i] = new Contender<Lock>( lock, acquisitions[i] );
+    } // for
+    uThisTask().sleep( Period );			// let contenders run on the other processors
+    stop = true;
+    for ( unsigned int i = 0; i < ntasks; i += 1 ) {
+	delete tasks[i];
+    } // for
+
+    unsigned long int total = 0, min = ~0ul, max = 0;
+    for ( unsigned int i = 0; i < ntasks; i += 1 ) {
+	total += acquisitions[i];
+	if ( acquisitions[i] < min ) min = acquisitions[i];
+	if ( acquisitions[i] > max ) max = acquisitions[i];
+    } // for
+    cout << setw(12) << (unsigned long int)( total / ( Period.nanoseconds() / 1000000000.0 ) )
+	 << setw(8) << setprecision(2) << fixed << ( max == 0 ? 0.0 : (double)min / max );
+} // contend
+
+int main( int argc, char *argv[] ) {
+    unsigned int nprocs = 8;
+    if ( argc > 1 ) nprocs = atoi( argv[1] );
+    if ( nprocs < 1 || nprocs > MaxProcessors ) {
+	cerr << "Usage: " << argv[0] << " [ maximum processors (1-" << MaxProcessors << ") ]" << endl;
+	exit( EXIT_FAILURE );
+    } // if
+
+    cout << setw(6) << "procs" << setw(12) << "uSpinLock/s" << setw(8) << "fair" << setw(12) << "uMCSLock/s" << setw(8) << "fair"
+	 << setw(12) << "yield ns" << endl;
+    for ( unsigned int n = 1; n <= nprocs; n = n < nprocs && n * 2 > nprocs ? nprocs : n * 2 ) {
+	uProcessor *processors = new uProcessor[n];	// one processor per contender; user processor sleeps
+	cout << setw(6) << n;
+	contend<uSpinLock>( n );
+	contend<uMCSLock>( n );
+
+	uTime start = uThisProcessor().getClock().getTime();
+	{
+	    Yielder *tasks = new Yielder[n * 2];	// keep every processor busy
+	    delete [] tasks;
+	}
+	cout << setw(12) << ( uThisProcessor().getClock().getTime() - start ).nanoseconds() / ( Yields * n * 2 ) << endl;
+	delete [] processors;
+    } // for
+} // main
+
+// Local Variables: //
+// compile-command: "u++-work -O2 -multi SpinLockContention.cc" //
+// End: //
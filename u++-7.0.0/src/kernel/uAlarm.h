@@ -82,11 +82,16 @@ class uEventList {
     friend class uEventListPop;				// access: eventLock, eventlist
     friend class uEventNode;				// access: addEvent, removeEvent
   protected:
-    uSpinLock eventLock;				// protect EventQueue
+    // All processors add and remove timeout events, so the lock and list start their own cache line.
+    uKernelSpinLock eventLock __attribute__(( aligned (uCacheLine()) )); // protect EventQueue
     uSequence<uEventNode> eventlist;			// event list
 
     virtual ~uEventList() {}
 
+    void *operator new( size_t size ) {
+	return ::memalign( uCacheLine(), size );	// size of cache line to prevent false sharing
+    } // uEventList::operator new
+
     void addEvent( uEventNode &newAlarm, bool block = false );
     void removeEvent( uEventNode &event );
 
@@ -36,6 +36,11 @@
 // gcc-7 uses xmms instructions, which require 16 byte alignment.
 #define uAlign() (16)
 
+// Size used to separate data modified by different processors so it does not share a cache line (false sharing). The
+// value covers the adjacent-line prefetcher on x86, which pulls cache lines in pairs.
+
+#define uCacheLine() (128)
+
 // Check for power of 2
 
 static inline bool uPow2( unsigned long int value ) {
@@ -82,6 +82,8 @@ void uBaseTask::createTask( uCluster &cluster ) {
 	heapData = nullptr;
 	uHeapControl::prepareTask( this );
     } // if
+
+    if ( ! userStack ) cluster.numaPlace( limit, size );	// stack pages from cluster's NUMA node, if any
 } // uBaseTask::createTask
 
 
@@ -221,6 +223,27 @@ void uBaseTask::wake() {
 } // uBaseTask::wake
 
 
+void uBaseTask::wake( uBaseTaskSeq &blocked ) {
+    // Unbound tasks on the waker's cluster are moved to its ready queue with one acquisition of the ready-queue lock,
+    // which also wakes as many idle processors as tasks. Other tasks are woken individually on their own cluster.
+
+    uCluster &cluster = uThisCluster();			// optimization
+    uBaseTaskSeq ready;
+    unsigned int n = 0;
+    for ( uBaseTaskDL *node = blocked.dropHead(); node != nullptr; node = blocked.dropHead() ) {
+	uBaseTask &task = node->task();
+	if ( task.currCluster == &cluster && (uProcessor *)(&task.bound) == nullptr ) {
+	    task.setState( Ready );			// task is marked available for execution
+	    ready.addTail( &(task.readyRef) );
+	    n += 1;
+	} else {
+	    task.wake();
+	} // if
+    } // for
+    if ( n != 0 ) cluster.makeTaskReady( ready, n );	// put the tasks on the ready queue of the cluster
+} // uBaseTask::wake
+
+
 uBaseTask::uBaseTask( uCluster &cluster ) : uBaseCoroutine( cluster.getStackSize() ), clusterRef( *this ), readyRef( *this ), entryRef( *this ), mutexRef( *this ), bound( *(uProcessor *)0 ) {
     createTask( cluster );
 } // uBaseTask::uBaseTask
@@ -259,7 +282,9 @@ uCluster &uBaseTask::migrate( uCluster &cluster ) {
 #endif // __U_LOCALDEBUGGER_H__
 
     // Remove the task from the list of tasks that live on this cluster, and add it to the list of tasks that live on
-    // the new cluster.
+    // the new cluster. With the default scheduler, the task is added when a processor of the new cluster moves it from
+    // the cluster's inbox to the ready queue, together with other tasks migrating at the same time; otherwise, the
+    // scheduler may reorder the cluster's tasks, so the task is added immediately.
 
     uCluster &prevCluster = *task.currCluster;		// save for return
 
@@ -276,7 +301,8 @@ uCluster &uBaseTask::migrate( uCluster &cluster ) {
 
     prevCluster.taskRemove( task );			// remove from current cluster
     task.currCluster = &cluster;			// change task's notion of which cluster it is executing on
-    cluster.taskAdd( task );				// add to new cluster
+    bool handoff = cluster.defaultReadyQueue;		// add through inbox ?
+    if ( ! handoff ) cluster.taskAdd( task );		// add to new cluster
 
     THREAD_GETMEM( This )->enableInterrupts();
 
@@ -297,9 +323,14 @@ uCluster &uBaseTask::migrate( uCluster &cluster ) {
     } // if
 #endif // __U_MULTI__ && __U_SWAPCONTEXT__
 
-    // Force a context switch so the task is scheduled on the new cluster.
+    // Force a context switch so the task is scheduled on the new cluster. The kernel pushes the task onto the inbox
+    // once it is off its stack.
 
-    yield();
+    if ( handoff ) {
+	UPP::uProcessorKernel::schedule( &cluster );
+    } else {
+	yield();
+    } // if
 
 #if defined( __U_MULTI__ ) && defined( __U_SWAPCONTEXT__ )
     // when stepping onto the system cluster, the SIGALRM must reset to unblocked
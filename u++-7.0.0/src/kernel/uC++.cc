@@ -65,6 +65,7 @@ using namespace UPP;
 int Statistics::ready_queue = 0, Statistics::spins = 0, Statistics::spin_sched = 0, Statistics::mutex_queue = 0,
     Statistics::owner_lock_queue = 0, Statistics::adaptive_lock_queue = 0, Statistics::io_lock_queue = 0,
     Statistics::uSpinLocks = 0, Statistics::uLocks = 0, Statistics::uOwnerLocks = 0, Statistics::uCondLocks = 0, Statistics::uSemaphores = 0, Statistics::uSerials = 0;
+int Statistics::owner_lock_spin = 0, Statistics::owner_lock_block = 0;
 
 // I/O statistics
 unsigned int Statistics::select_syscalls = 0, Statistics::select_errors = 0, Statistics::select_eintr = 0;
@@ -106,6 +107,9 @@ void UPP::Statistics::print() {
 		    " / uCondLocks %d"
 		    " / uSemaphores %d"
 		    " / uSerials %d\n"
+		    "  owner locks:"
+		    " spin acquires %d"
+		    " / blocks %d\n"
 		    "  signal:"
 		    " alarm %d"
 		    " / usr1 %d\n",
@@ -117,6 +121,8 @@ void UPP::Statistics::print() {
 		    Statistics::uCondLocks,
 		    Statistics::uSemaphores,
 		    Statistics::uSerials,
+		    Statistics::owner_lock_spin,
+		    Statistics::owner_lock_block,
 		    Statistics::signal_alarm,
 		    Statistics::signal_usr1 );
     uDebugWrite( STDOUT_FILENO, helpText, len );
@@ -232,8 +238,8 @@ unsigned int uKernelModule::numUserProcessors = 0;
 
 unsigned int uKernelModule::attaching = 0; // debugging
 
-char uKernelModule::systemClusterStorage[sizeof(uCluster)] __attribute__(( aligned (128) ));
-char uKernelModule::systemProcessorStorage[sizeof(uProcessor)] __attribute__(( aligned (16) ));
+char uKernelModule::systemClusterStorage[sizeof(uCluster)] __attribute__(( aligned (uCacheLine()) ));
+char uKernelModule::systemProcessorStorage[sizeof(uProcessor)] __attribute__(( aligned (uCacheLine()) ));
 char uKernelModule::bootTaskStorage[sizeof(uBootTask)] __attribute__(( aligned (16) ));
 
 std::filebuf *uKernelModule::cerrFilebuf = nullptr, *uKernelModule::clogFilebuf = nullptr, *uKernelModule::coutFilebuf = nullptr, *uKernelModule::cinFilebuf = nullptr;
@@ -451,6 +457,109 @@ bool uBaseSpinLock::tryacquire() {
 } // uBaseSpinLock::tryacquire
 
 
+//######################### uMCSLock #########################
+
+
+uMCSLock::Node * const uMCSLock::Waiting = (uMCSLock::Node *)1;
+
+void uMCSLock::acquire_( bool rollforward __attribute__(( unused )) ) {
+#if defined( __U_DEBUG__ ) && ! defined( __U_MULTI__ )
+    if ( held() ) {					// locked ?
+	abort( "(uMCSLock &)%p.acquire() : internal error, attempt to multiply acquire spin lock by same task.", this );
+    } // if
+#endif // __U_DEBUG__ && ! __U_MULTI__
+
+    // Interrupts remain disabled until release, even while queued, because the lock can be passed to this task at any
+    // time; rollforward is only meaningful at release.
+    THREAD_GETMEM( This )->disableIntSpinLock();
+
+#ifdef __U_MULTI__
+    for ( ;; ) {
+	Node *prev = lock.wait;
+	if ( prev == nullptr ) {			// lock open ?
+	  if ( uCompareAssign( lock.wait, (Node *)nullptr, &lock ) ) break; // no waiters, lock node is queue tail
+	} else {
+	    Node node;					// only referenced while waiting
+	    node.wait = Waiting;
+	    node.next = nullptr;
+	    if ( uCompareAssign( lock.wait, prev, &node ) ) { // append to queue
+		prev->next = &node;			// link behind predecessor
+		while ( __atomic_load_n( &node.wait, __ATOMIC_ACQUIRE ) == Waiting ) { // local spin
+		    uPause();
+		    if ( uKernelModule::globalSpinAbort ) _exit( EXIT_FAILURE ); // close down in progress, shutdown immediately!
+#ifdef __U_STATISTICS__
+		    uFetchAdd( Statistics::spins, 1 );
+#endif // __U_STATISTICS__
+		} // while
+
+		// Lock acquired, so move successor from stack node to lock node before the stack node disappears.
+		Node *succ = __atomic_load_n( &node.next, __ATOMIC_ACQUIRE );
+		if ( succ == nullptr ) {		// no known successor ?
+		    lock.next = nullptr;
+		    if ( ! uCompareAssign( lock.wait, &node, &lock ) ) { // successor arriving ?
+			while ( ( succ = __atomic_load_n( &node.next, __ATOMIC_ACQUIRE ) ) == nullptr ) uPause(); // wait for link
+			lock.next = succ;
+		    } // if
+		} else {
+		    lock.next = succ;
+		} // if
+		break;
+	    } // if
+	} // if
+	uPause();					// queue changed, retry
+    } // for
+#else
+    lock.wait = &lock;					// lock
+#endif // __U_MULTI__
+} // uMCSLock::acquire_
+
+
+void uMCSLock::release_( bool rollforward ) {
+    assert( held() );
+#ifdef __U_MULTI__
+    Node *succ = lock.next;
+    if ( succ == nullptr ) {				// no known successor ?
+	if ( ! uCompareAssign( lock.wait, &lock, (Node *)nullptr ) ) { // successor arriving ?
+	    while ( ( succ = __atomic_load_n( &lock.next, __ATOMIC_ACQUIRE ) ) == nullptr ) uPause(); // wait for link
+	} // if
+    } // if
+    if ( succ != nullptr ) {
+	__atomic_store_n( &succ->wait, (Node *)nullptr, __ATOMIC_RELEASE ); // pass lock to successor
+    } // if
+#else
+    lock.wait = nullptr;				// unlock
+#endif // __U_MULTI__
+    if ( rollforward ) {				// allow timeslicing during spinning
+	THREAD_GETMEM( This )->enableIntSpinLockNoRF();
+    } else {
+	THREAD_GETMEM( This )->enableIntSpinLock();
+    } // if
+} // uMCSLock::release_
+
+
+bool uMCSLock::tryacquire() {
+#if defined( __U_DEBUG__ ) && ! defined( __U_MULTI__ )
+    if ( held() ) {					// locked ?
+	abort( "(uMCSLock &)%p.tryacquire() : internal error, attempt to multiply acquire spin lock by same task.", this );
+    } // if
+#endif // __U_DEBUG__ && ! __U_MULTI__
+
+    THREAD_GETMEM( This )->disableIntSpinLock();
+
+#ifdef __U_MULTI__
+    if ( uCompareAssign( lock.wait, (Node *)nullptr, &lock ) ) { // get the lock ?
+	return true;
+    } else {
+	THREAD_GETMEM( This )->enableIntSpinLock();
+	return false;
+    } // if
+#else
+    lock.wait = &lock;					// lock
+    return true;
+#endif // __U_MULTI__
+} // uMCSLock::tryacquire
+
+
 //######################### uLock #########################
 
 
@@ -510,6 +619,34 @@ void uOwnerLock::release_() {				// used by uCondLock::wait
 } // uOwnerLock::release_
 
 
+void uOwnerLock::spin() {
+    // A task finding the lock held by a task running on another processor spins for a short time because the owner may
+    // release the lock sooner than the cost of blocking and waking. The spin budget adapts per lock: it tracks twice the
+    // average number of spins needed when spinning succeeds, and decays when spinning fails, so locks held for long
+    // periods quickly stop spinning. Updates to the average are racy, which is acceptable for a heuristic.
+
+    int budget = spins * 2 + SpinMin;
+    if ( budget > SpinMax ) budget = SpinMax;
+    for ( int cnt = 0; cnt < budget; cnt += 1 ) {
+	uBaseTask *testOwner = __atomic_load_n( &owner_, __ATOMIC_RELAXED );
+	if ( testOwner == nullptr ) {			// released ?
+	    spins += ( cnt - spins ) / 8;		// adjust average toward successful spin count
+#ifdef __U_STATISTICS__
+	    uFetchAdd( Statistics::owner_lock_spin, 1 );
+#endif // __U_STATISTICS__
+	    return;
+	} // if
+	// SKULLDUGGERY: Do not spin if the owner is not running on another processor.  But what if owner_ gets deleted
+	// while checking?  If getState could fault then we're toast, and we can't check.  However, if getState merely
+	// returns an arbitrary value we're ok, since this is only an optimization.
+      if ( testOwner->getState() != uBaseTask::Running ) return; // owner blocked or preempted => block
+	uPause();
+    } // for
+    spins -= spins / 8 + 1;				// spinning failed, reduce future budget
+    if ( spins < 0 ) spins = 0;
+} // uOwnerLock::spin
+
+
 uDEBUG(
     uOwnerLock::~uOwnerLock() {
 	spinLock.acquire();
@@ -527,6 +664,11 @@ void uOwnerLock::acquire() {
     assert( uKernelModule::initialized ? ! THREAD_GETMEM( disableInt ) && THREAD_GETMEM( disableIntCnt ) == 0 : true );
 
     uBaseTask &task = uThisTask();			// optimization
+#ifdef __U_MULTI__
+    if ( owner_ != nullptr && owner_ != &task ) {	// lock in use by another task ?
+	spin();						// owner on another processor may release soon
+    } // if
+#endif // __U_MULTI__
     spinLock.acquire();
 #ifdef KNOT
     task.setActivePriority( task.getActivePriorityValue() + 1 );
@@ -536,6 +678,7 @@ void uOwnerLock::acquire() {
 	    waiting.addTail( &(task.entryRef) );	// suspend current task
 #ifdef __U_STATISTICS__
 	    uFetchAdd( Statistics::owner_lock_queue, 1 );
+	    uFetchAdd( Statistics::owner_lock_block, 1 );
 #endif // __U_STATISTICS__
 	    uProcessorKernel::schedule( &spinLock );	// atomically release owner spin lock and block
 #ifdef __U_STATISTICS__
@@ -1127,6 +1270,7 @@ namespace UPP {
 #endif // __U_STATISTICS__
 	mask.clrAll();					// mutex members start closed
 	mutexOwner = &uThisTask();			// set the current mutex owner to the creating task
+	fastOwner = Slow;				// opened by first idle leave
 
 	// Make creating task the owner of the mutex.
 	prevSerial = &mutexOwner->getSerial();		// save previous serial
@@ -1136,6 +1280,7 @@ namespace UPP {
 
 	acceptMask = false;
 	mutexMaskLocn = nullptr;
+	reentryPending = 0;
 
 	destructorTask = nullptr;
 	destructorStatus = NoDestructor;
@@ -1173,6 +1318,26 @@ namespace UPP {
 	    uProcessorKernel::schedule( mutexOwner );
 	} // for
 
+	// Tasks restarted by signalAll in the destructor, like signalled tasks, must reenter before the serial goes away,
+	// so the destructor waits for those not yet queued on the reentry queue.
+	for ( ;; ) {
+	    spinLock.acquire();
+	  if ( reentryPending == 0 ) break;
+	    uBaseTaskDL *p = reentryList.drop();
+	    if ( p == nullptr ) {			// restarted task not yet queued ?
+		spinLock.release();
+		uBaseTask::yield();
+		continue;
+	    } // if
+	    reentryPending -= 1;
+	    mutexOwner = &(p->task());
+	    entryList.remove( &(mutexOwner->entryRef) ); // also remove task from entry queue
+	    _Resume uMutexFailure::EntryFailure( this, "blocked on reentry queue" ) _At *(mutexOwner->currCoroutine);
+	    acceptSignalled.add( &(task.mutexRef) );	// suspend current task on top of accept/signalled stack
+	    uProcessorKernel::schedule( &spinLock, mutexOwner );
+	} // for
+	spinLock.release();
+
 	if ( ! entryList.empty() ) {			// no need to acquire the lock if the queue is empty
 	    for ( ;; ) {
 		spinLock.acquire();
@@ -1189,6 +1354,27 @@ namespace UPP {
     } // uSerial::~uSerial
 
 
+    uBaseTask * const uSerial::Slow = (uBaseTask *)1;
+
+
+    void uSerial::closeFast() {
+	for ( ;; ) {
+	    uBaseTask *owner = fastOwner;
+	  if ( owner == Slow ) break;
+	    // Set the serial state before closing so currentOwner is never null for an owner.
+	    if ( owner == nullptr ) {			// free => state already idle
+		mutexOwner = nullptr;
+		mask.setAll();				// accept all members
+		mask.clr( 0 );				// except timeout
+	    } else {					// fast owner => make it the mutex owner
+		mutexOwner = owner;
+		mask.clrAll();
+	    } // if
+	  if ( uCompareAssign( fastOwner, owner, Slow ) ) break; // owner may leave concurrently
+	} // for
+    } // uSerial::closeFast
+
+
     void uSerial::resetDestructorStatus() {
 	destructorStatus = NoDestructor;
 	destructorTask = nullptr;
@@ -1197,7 +1383,20 @@ namespace UPP {
 
     void uSerial::enter( unsigned int &mr, uBasePrioritySeq &ml, int mp ) {
 	uBaseTask &task = uThisTask();			// optimization
+
+	uBaseTask *owner = fastOwner;
+	if ( owner == &task ) {				// already hold mutex through fast path ?
+	    task.mutexRecursion += 1;			// another recursive call at the mutex object level
+	    return;
+	} // if
+	if ( owner == nullptr && uCompareAssign( fastOwner, owner, &task ) ) { // uncontended ?
+	    mr = task.mutexRecursion;			// save previous recursive count
+	    task.mutexRecursion = 0;			// reset recursive count
+	    return;
+	} // if
+
 	spinLock.acquire();
+	closeFast();
 
 	uDEBUGPRT( uDebugPrt( "(uSerial &)%p.enter enter, mask:0x%x,0x%x,0x%x,0x%x, owner:%p, maskposn:%p, ml:%p, mp:%d\n",
 			      this, mask[0], mask[1], mask[2], mask[3], mutexOwner, mutexMaskLocn, &ml, mp ); )
@@ -1244,6 +1443,7 @@ namespace UPP {
 	} // if
 
 	spinLock.acquire();
+	closeFast();
 
 	destructorStatus = DestrCalled;
 	destructorTask = &task;
@@ -1304,6 +1504,35 @@ namespace UPP {
     } // uSerial::enterTimeout
 
 
+    void uSerial::reenter() {
+	// A task restarted by uCondition::signalAll does not own the mutex object. While restarted tasks are pending, the
+	// mutex object is never opened to entry callers (no barging), so a restarted task takes the mutex object if no task
+	// holds it, is suspended in it or is accepted (mask clear), and otherwise waits on the reentry queue, which is
+	// served before the entry queue.
+
+	uBaseTask &task = uThisTask();			// optimization
+
+	spinLock.acquire();
+	closeFast();
+	if ( mutexOwner == nullptr && acceptSignalled.empty() && mask.isAllClr() ) { // mutex object held for restarted tasks ?
+	    mask.clrAll();				// clear the mask
+	    mutexOwner = &task;				// set the current mutex owner
+	    reentryPending -= 1;
+	    if ( entryList.executeHooks ) {
+		entryList.onAcquire( *mutexOwner );	// perform any priority inheritance
+	    } // if
+	    spinLock.release();
+	} else {					// otherwise block the calling task
+	    reentryList.add( &(task.mutexRef), mutexOwner ); // add to end of reentry queue
+	    task.calledEntryMem = &reentryList;		// remember which queue to leave
+	    entryList.add( &(task.entryRef), mutexOwner ); // also on entry queue for destructor
+	    uProcessorKernel::schedule( &spinLock );	// find someone else to execute; release lock on kernel stack
+	} // if
+	uDEBUGPRT( uDebugPrt( "(uSerial &)%p.reenter exit, mask:0x%x,0x%x,0x%x,0x%x, owner:%p\n",
+			      this, mask[0], mask[1], mask[2], mask[3], mutexOwner ); )
+    } // uSerial::reenter
+
+
     // leave and leave2 do not poll for concurrent exceptions because they are called in some critical destructors.
     // Throwing an exception out of these destructors causes problems.
 
@@ -1312,6 +1541,18 @@ namespace UPP {
 			      this, mask[0], mask[1], mask[2], mask[3], mutexOwner, mr ); )
 	uBaseTask &task = uThisTask();			// optimization
 
+	if ( fastOwner == &task && acceptSignalled.empty() ) { // entered through fast path and no signalled tasks ?
+	    if ( task.mutexRecursion != 0 ) {		// recursive call ?
+		task.mutexRecursion -= 1;
+		return;
+	    } // if
+	    if ( uCompareAssign( fastOwner, &task, (uBaseTask *)nullptr ) ) { // no closeFast ?
+		task.mutexRecursion = mr;		// restore previous recursive count
+		return;
+	    } // if
+	} // if
+	slow();
+
 	if ( task.mutexRecursion != 0 ) {		// already hold mutex ?
 	    if ( acceptMask ) {
 		// lock is acquired and mask set by accept statement
@@ -1331,7 +1572,26 @@ namespace UPP {
 		spinLock.release();
 	    } else if ( acceptSignalled.empty() ) {	// no tasks waiting re-entry to mutex object ?
 		spinLock.acquire();
-		if ( destructorStatus != DestrCalled ) {
+		if ( ! reentryList.empty() ) {		// tasks restarted by signalAll go before entry callers and destructor
+		    mutexOwner = &(reentryList.drop()->task()); // next task to gain control of the mutex object
+		    entryList.remove( &(mutexOwner->entryRef) ); // also remove task from entry queue
+		    reentryPending -= 1;
+		    if ( entryList.executeHooks ) {
+			if ( checkHookConditions( &task ) ) entryList.onRelease( task );
+			if ( checkHookConditions( mutexOwner ) ) entryList.onAcquire( *mutexOwner );
+		    } // if
+		    if ( &task == destructorTask ) resetDestructorStatus();
+		    spinLock.release();
+		    uDEBUGPRT( uDebugPrt( "(uSerial &)%p.leave, waking task %.256s (%p)\n", this, mutexOwner->getName(), mutexOwner ); )
+		    mutexOwner->wake();			// wake up next task to use this mutex object
+		} else if ( reentryPending != 0 ) {	// restarted tasks not yet queued ?
+		    mutexOwner = nullptr;		// held for restarted tasks: mask stays clear and fast path closed
+		    if ( entryList.executeHooks && checkHookConditions( &task ) ) {
+			entryList.onRelease( task );
+		    } // if
+		    if ( &task == destructorTask ) resetDestructorStatus();
+		    spinLock.release();
+		} else if ( destructorStatus != DestrCalled ) {
 		    if ( entryList.empty() ) {		// no tasks waiting entry to mutex object ?
 			mask.setAll();			// accept all members
 			mask.clr( 0 );			// except timeout
@@ -1340,6 +1600,9 @@ namespace UPP {
 			    entryList.onRelease( task );
 			} // if
 			if ( &task == destructorTask ) resetDestructorStatus();
+			if ( ! entryList.executeHooks && destructorStatus == NoDestructor && mutexMaskLocn == nullptr ) {
+			    __atomic_store_n( &fastOwner, (uBaseTask *)nullptr, __ATOMIC_RELEASE ); // reopen fast path
+			} // if
 			spinLock.release();
 		    } else {				// tasks wating entry to mutex object
 			mutexOwner = &(entryList.drop()->task()); // next task to gain control of the mutex object
@@ -1397,6 +1660,7 @@ namespace UPP {
 
     void uSerial::leave2() {				// used when a task is leaving a mutex and has queued itself before calling
 	uBaseTask &task = uThisTask();			// optimization
+	slow();
 
 	if ( acceptMask ) {
 	    // lock is acquired and mask set by accept statement
@@ -1409,7 +1673,23 @@ namespace UPP {
 	    uProcessorKernel::schedule( &spinLock );	// find someone else to execute; release lock on kernel stack
 	} else if ( acceptSignalled.empty() ) {		// no tasks waiting re-entry to mutex object ?
 	    spinLock.acquire();
-	    if ( destructorStatus != DestrCalled ) {
+	    if ( ! reentryList.empty() ) {		// tasks restarted by signalAll go before entry callers and destructor
+		mutexOwner = &(reentryList.drop()->task()); // next task to gain control of the mutex object
+		entryList.remove( &(mutexOwner->entryRef) ); // also remove task from entry queue
+		reentryPending -= 1;
+		if ( entryList.executeHooks ) {
+		    if ( checkHookConditions( &task ) ) entryList.onRelease( task );
+		    if ( checkHookConditions( mutexOwner ) ) entryList.onAcquire( *mutexOwner );
+		} // if
+		uDEBUGPRT( uDebugPrt( "(uSerial &)%p.leave2, waking task %.256s (%p)\n", this, mutexOwner->getName(), mutexOwner ); )
+		uProcessorKernel::schedule( &spinLock, mutexOwner ); // find someone else to execute; release lock and wake on kernel stack
+	    } else if ( reentryPending != 0 ) {		// restarted tasks not yet queued ?
+		mutexOwner = nullptr;			// held for restarted tasks: mask stays clear and fast path closed
+		if ( entryList.executeHooks && checkHookConditions( &task ) ) {
+		    entryList.onRelease( task );
+		} // if
+		uProcessorKernel::schedule( &spinLock ); // find someone else to execute; release lock on kernel stack
+	    } else if ( destructorStatus != DestrCalled ) {
 		if ( entryList.empty() ) {		// no tasks waiting entry to mutex object ?
 		    mask.setAll();			// accept all members
 		    mask.clr( 0 );			// except timeout
@@ -1479,6 +1759,7 @@ namespace UPP {
 #if defined( __U_DEBUG__ ) || defined( __U_PROFILER__ )
 	uBaseTask &task = uThisTask();			// optimization
 #endif // __U_DEBUG__ || __U_PROFILER__
+	slow();						// accept uses the mask
 	uDEBUG(
 	    if ( &task != mutexOwner ) {		// must have mutex lock to wait
 		abort( "Attempt to accept in a mutex object not locked by this task.\n"
@@ -1891,7 +2172,7 @@ void uCondition::wait() {				// wait on a condition
     UPP::uSerial &serial = task.getSerial();
 
     uDEBUG(
-	if ( owner != nullptr && &task != owner->mutexOwner ) { // must have mutex lock to wait
+	if ( owner != nullptr && &task != owner->currentOwner() ) { // must have mutex lock to wait
 	    abort( uConditionMsg( "wait on" ) );
 	} // if
     )
@@ -1910,6 +2191,7 @@ void uCondition::wait() {				// wait on a condition
     waiting.add( &(task.mutexRef) );			// add to end of condition queue
 
     serial.leave2();					// release mutex and let it schedule another task
+    if ( serial.currentOwner() != &task ) serial.reenter(); // restarted by signalAll ?
 
     _Enable <uMutexFailure><WaitingFailure>;		// implicit poll
 
@@ -1924,7 +2206,7 @@ void uCondition::wait() {				// wait on a condition
 uDEBUG(
 #define uSignalCheck() \
     /* must have mutex lock to signal */ \
-    if ( owner != nullptr && &task != owner->mutexOwner ) abort( uConditionMsg( "signal" ) );
+    if ( owner != nullptr && &task != owner->currentOwner() ) abort( uConditionMsg( "signal" ) );
 )
 
 
@@ -1975,6 +2257,39 @@ bool uCondition::signalBlock() {			// signal a condition
 } // uCondition::signalBlock
 
 
+bool uCondition::signalAll() {				// signal all tasks on a condition
+  if ( waiting.empty() ) return false;			// signal on empty condition is no-op
+
+    uBaseTask &task = uThisTask();			// optimization
+    UPP::uSerial &serial = task.getSerial();
+    uDEBUG( uSignalCheck(); )
+
+#ifdef __U_PROFILER__
+    if ( task.profileActive && uProfiler::uProfiler_registerSignal ) { // task registered for profiling ?
+	(*uProfiler::uProfiler_registerSignal)( uProfiler::profilerInstance, *this, task, serial );
+    } // if
+#endif // __U_PROFILER__
+
+    // Rather than passing the mutex object from task to task through the accept/signalled stack, with a context switch
+    // each, the waiting tasks are made ready together and regain the mutex object in turn after the signaller leaves,
+    // so their wake-ups proceed in parallel on idle processors. The restarted tasks are counted in the serial, which
+    // keeps the mutex object closed to entry callers until all of them have regained it.
+
+    uBaseTaskSeq restart;
+    unsigned int n = 0;
+    for ( uBaseTaskDL *p = waiting.drop(); p != nullptr; p = waiting.drop() ) {
+	restart.addTail( p );
+	n += 1;
+    } // for
+    serial.spinLock.acquire();
+    serial.closeFast();					// signaller must leave through the slow path
+    serial.reentryPending += n;
+    serial.spinLock.release();
+    uBaseTask::wake( restart );
+    return true;
+} // uCondition::signalAll
+
+
 uCondition::WaitingFailure::WaitingFailure( const uCondition &cond, const char *const msg ) : uKernelFailure( msg ), cond( cond ) {}
 
 uCondition::WaitingFailure::~WaitingFailure() {}
@@ -219,6 +219,10 @@ extern "C" {
     size_t malloc_usable_size( void *addr ) __THROW;
     void malloc_stats() __THROW;
     int malloc_stats_fd( int fd ) __THROW;
+    int malloc_trim( size_t pad ) __THROW;
+    int malloc_profile( int fd ) __THROW;
+    void free_sized( void *addr, size_t size ) __THROW;
+    void free_bulk( void *addrs[], size_t n ) __THROW;
 } // extern "C"
 
 #if defined( __U_MULTI__ )
@@ -234,6 +238,10 @@ extern "C" {
 #ifndef M_TOP_PAD
 #define M_TOP_PAD (-2)
 #endif // M_TOP_PAD
+#define M_PURGE_DECAY (-32)				// milliseconds before unused free pages are returned to the OS, 0 => never
+#define M_HUGE_PAGES (-33)				// heap huge-page mode, see __U_DEFAULT_HEAP_HUGE_PAGES__
+#define M_SAMPLE_RATE (-34)				// mean bytes allocated between heap-profile samples, 0 => off
+#define M_PROFILE_SIGNAL (-35)				// signal writing heap profile to heap.PID.N.prof at next sample, 0 => none
 
 
 #ifdef __U_STATISTICS__
@@ -241,6 +249,7 @@ namespace UPP {
     struct Statistics {
 	// Kernel, signed because of the atomic inc/dec
 	static int ready_queue, spins, spin_sched, mutex_queue, owner_lock_queue, adaptive_lock_queue, io_lock_queue;
+	static int owner_lock_spin, owner_lock_block;
 	static int uSpinLocks, uLocks, uOwnerLocks, uCondLocks, uSemaphores, uSerials;
 
 	// I/O statistics
@@ -295,6 +304,7 @@ class uCondition;					// forward declaration
 class uTimeoutHndlr;					// forward declaration
 class uWakeupHndlr;					// forward declaration
 class uRWLock;						// forward declaration
+class uTreeBarrier;					// forward declaration
 
 namespace UPP {
     enum  uAction { uNo, uYes };			// forward declaration
@@ -303,6 +313,7 @@ namespace UPP {
     _Task uBootTask;					// forward declaration
     class uHeapManager;					// forward declaration
     class uHeapControl;					// forward declaration
+    struct uHeapCache;					// forward declaration
     class uSerial;					// forward declaration
     class uSerialConstructor;				// forward declaration
     class uSerialDestructor;				// forward declaration
@@ -524,6 +535,8 @@ class uKernelModule {
 	bool RFpending;					// roll forward pending and needs execution
 
 	UPP::uProcessorKernel *processorKernelStorage;	// system-cluster processor kernel
+	UPP::uHeapCache *heapCache;			// free-block magazines of the heap for this kernel thread
+	long int heapSampleBytes;			// bytes allocated by this kernel thread before next heap-profile sample
 
 	// The thread pointer value needs to be accessible so that it can be properly restored on context switches.  On
 	// a non-tls system the thread pointer points directly at the kernel module, i.e. tp == This.  On a tls system
@@ -695,14 +708,82 @@ class uBaseSpinLock {					// non-yielding spinlock
 }; // uBaseSpinLock
 
 
-class uSpinLock : public uBaseSpinLock {		// handle alignment to prevent false sharing
-//    char padding[128 - sizeof(uBaseSpinLock)];		// pad to size of cacheline
+// uSpinLock is not padded to a cache line because it is embedded in every mutex object (uSerial) and heap bucket, where
+// the extra storage is prohibitive. Kernel structures shared among processors instead align their hot locks explicitly
+// (see uCluster, uProcessor and uEventList), and a dynamically allocated spin lock occupies its own cache line.
+
+class uSpinLock : public uBaseSpinLock {
   public:
     void *operator new( size_t size ) {			// dynamic allocation
-//	return ::memalign( 128, size );
-	return ::malloc( size );
+	return ::memalign( uCacheLine(), uCeiling( size, uCacheLine() ) ); // prevent false sharing
     } // uSpinLock::operator new
-}; // __attribute__(( aligned (128) ));			// static allocation
+}; // uSpinLock
+
+
+// uMCSLock is a non-yielding FIFO queue lock (MCS lock, K42 variant) for kernel locks contended by many processors.
+// Each waiter spins on a flag in its own queue node, rather than all waiters hammering the lock word, so the lock cache
+// line is not bounced among processors and the lock is granted in arrival order.  The lock contains its own queue node
+// for the lock holder, so acquire/release have the same interface as uSpinLock, and a waiter's queue node is on its
+// stack and only referenced while it waits.  Unlike uSpinLock, interrupts stay disabled while a task is queued because
+// a queued task cannot be time sliced without blocking all tasks behind it; a roll forward pending during the wait is
+// performed at release, as for uSpinLock.
+
+class uMCSLock {					// non-yielding FIFO queue spinlock
+    friend class UPP::uKernelBoot;			// access: new
+    friend class uEventListPop;				// access: acquire_, release_
+    friend class uCluster;				// access: held
+
+    struct Node {
+	Node * volatile wait;				// Waiting => predecessor still holds the lock
+	Node * volatile next;				// successor in queue
+    }; // Node
+
+    static Node * const Waiting;
+
+    Node lock;						// lock.wait: last node in queue (nullptr => unlocked), lock.next: first waiter
+
+    void acquire_( bool rollforward );
+    void release_( bool rollforward );
+    bool held() const { return lock.wait != nullptr; }
+  public:
+    uMCSLock( const uMCSLock & ) = delete;		// no copy
+    uMCSLock( uMCSLock && ) = delete;
+    uMCSLock &operator=( const uMCSLock & ) = delete;	// no assignment
+
+    uMCSLock() {
+#ifdef __U_STATISTICS__
+	uFetchAdd( UPP::Statistics::uSpinLocks, 1 );
+#endif // __U_STATISTICS__
+	lock.wait = lock.next = nullptr;		// unlock
+    } // uMCSLock::uMCSLock
+
+    void *operator new( size_t size ) {			// dynamic allocation
+	return ::memalign( uCacheLine(), uCeiling( size, uCacheLine() ) ); // prevent false sharing
+    } // uMCSLock::operator new
+
+    void acquire() {
+	acquire_( false );
+	asm( "" : : : "memory" );			// prevent code movement across barrier
+    } // uMCSLock::acquire
+
+    bool tryacquire();
+
+    void release() {
+	asm( "" : : : "memory" );			// prevent code movement across barrier
+	release_( false );
+    } // uMCSLock::release
+}; // uMCSLock
+
+
+// Lock type for the kernel locks acquired by every processor on a cluster (ready queue and event list).  Building with
+// QUEUELOCK=TRUE replaces the test-and-set lock by the queue lock, which scales better with many processors but costs
+// an extra atomic instruction on release when uncontended.
+
+#ifdef __U_QUEUELOCK__
+typedef uMCSLock uKernelSpinLock;
+#else
+typedef uSpinLock uKernelSpinLock;
+#endif // __U_QUEUELOCK__
 
 
 // RAII mutual-exclusion lock.  Useful for mutual exclusion in free routines.  Handles exception termination and
@@ -760,7 +841,7 @@ class uLock {						// yielding spinlock
     } // uLock::release
 
     void *operator new( size_t size ) {
-	return ::memalign( 128, size );			// size of cache line to prevent false sharing
+	return ::memalign( uCacheLine(), size );	// size of cache line to prevent false sharing
     } // uLock::operator new
 }; // uLock
 
@@ -871,7 +952,11 @@ class uOwnerLock {
     // magic value (see library/pthread.cc).
     uBaseTask *owner_;					// owner with respect to recursive entry
     uSequence<uBaseTaskDL> waiting;			// sequence versus queue to reduce size to 24 bytes => more expensive
+    int spins;						// running average of spins to acquire lock released by running owner
+
+    enum { SpinMin = 16, SpinMax = 1024 };		// bounds for adaptive spinning before blocking
 
+    void spin();
     void add_( uBaseTask &task );			// helper routines for uCondLock
     void release_();
   public:
@@ -885,6 +970,7 @@ class uOwnerLock {
 #endif // __U_STATISTICS__
 	owner_ = nullptr;				// no one owns the lock
 	count = 0;					// so count is zero
+	spins = 0;					// no spinning history
     } // uOwnerLock::uOwnerLock
 
     uDEBUG( ~uOwnerLock(); )
@@ -984,7 +1070,7 @@ namespace UPP {
 	// sem_t, if sizeof(sem_t) >= sizeof(uSemaphore).
 
 	uBaseSpinLock spinLock;				// must be first field for alignment
-	int count;
+	volatile int count;				// changed atomically, negative => -count waiting tasks
 	uQueue<uBaseTaskDL> waiting;
 
 	void waitTimeout( TimedWaitHandler &h );
@@ -1109,6 +1195,45 @@ extern "C" void uSwitch( void *from, void *to ) asm ("uSwitch"); // assembler ro
 #endif
 
 
+// Per-processor cache of coroutine/task stacks. Stacks are mapped with MAP_NORESERVE, so only the pages a stack actually
+// touches are committed, and a write-protected guard page below each stack catches overflow. Freed stacks are cached by
+// mapping size so creating short-lived tasks does not pay for a mapping and its page faults. Beyond HighWater cached
+// stacks of a size, the pages of a freed stack are returned to the OS (MADV_DONTNEED) but the mapping is kept; beyond
+// MaxCached the stack is unmapped.
+
+namespace UPP {
+    class uStackPool {
+	friend class uMachContext;			// access: get, put
+
+	enum { Sizes = 4, HighWater = 8, MaxCached = 32 };
+
+	struct Bucket {
+	    size_t len;					// mapping size of stacks in bucket, 0 => unused
+	    void *stacks;				// list of stacks linked through last word of mapping
+	    unsigned int cnt;				// number of stacks in list
+	} buckets[Sizes];
+	bool closed;					// processor deleted => do not cache
+
+	static void *&link( void *storage, size_t len ) {
+	    return *(void **)((char *)storage + len - sizeof(void *));
+	} // uStackPool::link
+
+	void *pop( size_t len );
+	bool push( void *storage, size_t len );
+
+	static void *get( size_t len, size_t guard );
+	static void put( void *storage, size_t len );
+      public:
+	uStackPool( const uStackPool & ) = delete;	// no copy
+	uStackPool( uStackPool && ) = delete;
+	uStackPool &operator=( const uStackPool & ) = delete; // no assignment
+
+	uStackPool();
+	~uStackPool();
+    }; // uStackPool
+} // UPP
+
+
 // Contains the machine dependent context and routines that initialize and switch between contexts.
 
 namespace UPP {
@@ -1116,10 +1241,11 @@ namespace UPP {
 	friend class ::uContext;			// access: extras, additionalContexts
 	friend class ::uProcessorTask;			// access: size, base, limit
 	friend class ::uBaseCoroutine;			// access: storage
-	friend class ::uBaseTask;			// access: context
+	friend class ::uBaseTask;			// access: context, limit, size, userStack
 	friend _Coroutine uProcessorKernel;		// access: storage
 	friend class ::uProcessor;			// access: storage
 	friend class uKernelBoot;			// access: storage
+	friend class ::uCluster;			// access: pageSize
 	friend void *uKernelModule::startThread( void *p ); // acesss: invokeCoroutine
 
 	struct uContext_t {				// name mimics ucontext_t from Linux headers
@@ -1204,12 +1330,7 @@ namespace UPP {
 
 	virtual ~uMachContext() {
 	    if ( ! userStack ) {
-		uDEBUG(
-		    if ( ::mprotect( storage, pageSize, PROT_READ | PROT_WRITE ) == -1 ) {
-			abort( "(uMachContext &)%p.~uMachContext() : internal error, mprotect failure, error(%d) %s.", this, errno, strerror( errno ) );
-		    } // if
-		)
-		free( storage );
+		uStackPool::put( storage, uCeiling( (char *)top - (char *)storage, pageSize ) ); // cache or unmap stack
 	    } // if
 	} // uMachContext::~uMachContext
 
@@ -1739,10 +1860,11 @@ class uBaseTask : public uBaseCoroutine {
     friend class uBaseSpinLock;				// access: profileActive
     friend class UPP::uSemaphore;			// access: entryRef, wake
     friend class uRWLock;				// access: entryRef, wake, info
-    friend class uCondition;				// access: currCoroutine, mutexRef, info, profileActive
+    friend class uTreeBarrier;				// access: entryRef, wake
+    friend class uCondition;				// access: currCoroutine, mutexRef, info, profileActive, wake
     friend _Coroutine UPP::uProcessorKernel;		// access: currCoroutine, setState, wake
     friend _Task uProcessorTask;			// access: currCluster, uBaseTask
-    friend class uCluster;				// access: currCluster, readyRef, clusterRef, bound
+    friend class uCluster;				// access: currCluster, readyRef, clusterRef, bound, inboxNext, migrateTime, setState
     friend _Task UPP::uBootTask;			// access: wake
     friend class UPP::uHeapManager;			// access: profileActive
     friend class uKernelModule;				// access: currCoroutine, inheritTask
@@ -1784,6 +1906,7 @@ class uBaseTask : public uBaseCoroutine {
     uBaseTask( uCluster &cluster, uProcessor &processor ); // only used by uProcessorTask
     void setState( State state );
     void wake();
+    static void wake( uBaseTaskSeq &blocked );		// wake all tasks, same cluster tasks in one ready-queue insertion
 
     // debugging : must be first fields
 
@@ -1802,6 +1925,8 @@ class uBaseTask : public uBaseCoroutine {
 
     uBaseTaskDL clusterRef;				// double link field: list of tasks on cluster
     uBaseTaskDL readyRef;				// double link field: ready queue
+    uBaseTask *inboxNext;				// single link field: inbox of cluster task is migrating to
+    uTime migrateTime;					// time task entered inbox, for migration latency
     uBaseTaskDL entryRef;				// double link field: general entry deque (all waiting tasks)
     uBaseTaskDL mutexRef;				// double link field: mutex member, suspend stack, condition variable
     uProcessor &bound;					// processor to which this task is bound, if applicable
@@ -2066,9 +2191,12 @@ namespace UPP {
 	// must be first field for alignment
 	uSpinLock spinLock;				// provide mutual exclusion while examining serial state
 	uBaseTask *mutexOwner;				// active thread in the mutex object
+	uBaseTask * volatile fastOwner;			// fast path: nullptr => free, Slow => closed, otherwise owner
 	uBitSet< __U_MAXENTRYBITS__ > mask;		// entry mask of accepted mutex members and timeout
 	unsigned int *mutexMaskLocn;			// location to place mask position in accept statement
 	uBasePrioritySeq &entryList;			// tasks waiting to enter mutex object
+	uBasePrioritySeq reentryList;			// tasks restarted by signalAll waiting to regain mutex object
+	unsigned int reentryPending;			// tasks restarted by signalAll not yet holding mutex object
 	uStack<uBaseTaskDL> acceptSignalled;		// tasks suspended within the mutex object
 	uBaseTask *constructorTask;			// identity of task creating mutex object
 	uBaseTask *destructorTask;			// identity of task calling mutex object's destructor
@@ -2093,10 +2221,32 @@ namespace UPP {
 
 	mutable uProfileTaskSampler *profileSerialSamplerInstance; // pointer to related profiling object
 
+	// An uncontended entry and exit is a single compare-and-swap of fastOwner without the spin lock. The fast path is
+	// open only while the mutex object is free with all members accepted, no waiting tasks, no priority hooks, and no
+	// destructor call. Any operation needing the full serial state closes it under the spin lock, which makes a fast
+	// owner the mutexOwner, and it is reopened by a leave that finds the mutex object idle.
+
+	static uBaseTask * const Slow;			// fast path closed
+
+	void closeFast();				// spin lock held
+	void slow() {					// called by owner before using the serial state
+	    if ( fastOwner != Slow ) {
+		spinLock.acquire();
+		closeFast();
+		spinLock.release();
+	    } // if
+	} // uSerial::slow
+
+	uBaseTask *currentOwner() const {		// owner on either path, only exact for the calling task
+	    uBaseTask *owner = fastOwner;
+	    return owner != Slow ? owner : mutexOwner;
+	} // uSerial::currentOwner
+
 	void resetDestructorStatus();			// allow destructor to be called
 	void enter( unsigned int &mr, uBasePrioritySeq &ml, int mp );
 	void enterDestructor( unsigned int &mr, uBasePrioritySeq &ml, int mp );
 	void enterTimeout();
+	void reenter();					// restarted by uCondition::signalAll
 	void leave( unsigned int mr );
 	void leave2();
 	void removeTimeout();
@@ -2354,6 +2504,7 @@ class uCondition {
     } // uCondition::wait
     bool signal();					// signal condition
     bool signalBlock();					// signal condition
+    bool signalAll();					// restart all waiting tasks, which regain the mutex object in turn before entry callers
 
     bool empty() const {				// test for tasks on a condition
 	return waiting.empty();				// check if the condition queue is empty
@@ -2487,6 +2638,7 @@ namespace UPP {
 	friend class ::uCondLock;			// access: schedule, kernelClock
 	friend class uSemaphore;			// access: schedule
 	friend class ::uRWLock;				// access: schedule
+	friend class ::uTreeBarrier;			// access: schedule
 	friend class ::uBaseTask;			// access: schedule, kernelClock
 	friend _Task ::uProcessorTask;			// access: terminated, kernelClock
 	friend class ::uProcessor;			// access: uProcessorKernel
@@ -2499,17 +2651,23 @@ namespace UPP {
 
 	unsigned int kind;				// specific kind of schedule operation
 	uBaseSpinLock *prevLock;			// comunication
+	uMCSLock *prevMCSLock;				// comunication
 	uBaseTask *nextTask;				// task to be wakened
+	uCluster *nextCluster;				// cluster receiving migrating task
 
 	void taskIsBlocking();
 	static void schedule();
 	static void schedule( uBaseSpinLock *lock );
+	static void schedule( uMCSLock *lock );
 	static void schedule( uBaseTask *task );
 	static void schedule( uBaseSpinLock *lock, uBaseTask *task );
+	static void schedule( uCluster *cluster );
 	void scheduleInternal();
 	void scheduleInternal( uBaseSpinLock *lock );
+	void scheduleInternal( uMCSLock *lock );
 	void scheduleInternal( uBaseTask *task );
 	void scheduleInternal( uBaseSpinLock *lock, uBaseTask *task );
+	void scheduleInternal( uCluster *cluster );
 	void onBehalfOfUser();
 	void setTimer( uDuration time );
 	void setTimer( uTime time );
@@ -2555,6 +2713,7 @@ class uProcessor {
     friend class uEventListPop;                         // access: contextSwitchHandler
     friend void *uKernelModule::startThread( void *p ); // acesss: everything
     friend class UPP::uMachContext;			// access: procTask
+    friend class UPP::uStackPool;			// access: stackPool
 #if defined( __i386__ ) || defined( __ia64__ ) && ! defined( __old_perfmon__ )
     friend class HWCounters;				// access: uPerfctrContext (i386) or uPerfmon_fd (ia64)
 #endif
@@ -2582,6 +2741,9 @@ class uProcessor {
 #endif // ! __U_MULTI__
     uCxtSwtchHndlr *contextSwitchHandler;		// special time slice handler
 
+    // Declared before processorKer so the pool outlives the processor-kernel stack, which may be returned to it.
+    UPP::uStackPool stackPool;				// cache of stacks freed on this processor
+
 #ifdef __U_MULTI__
     UPP::uProcessorKernel processorKer;			// need a uProcessorKernel
 #endif // __U_MULTI__
@@ -2610,15 +2772,20 @@ class uProcessor {
     unsigned int spin;
 
     uProcessorTask *procTask;				// handle processor specific requests
-    uBaseTaskSeq external;				// ready queue for processor task
 
     uCluster *currCluster;				// cluster processor currently associated with
 
     bool detached;					// processor detached ?
     bool terminated;                                    // processor being deleted ?
 
+    // Fields modified by other processors (holding the cluster's readyIdleTaskLock) when tasks are made ready or this
+    // processor is woken are isolated on their own cache line, so they do not invalidate the line holding the fields
+    // above, which this processor reads on every schedule.
+
+    uBaseTaskSeq external __attribute__(( aligned (uCacheLine()) )); // ready queue for processor task
     uProcessorDL idleRef;				// double link field: list of idle processors
-    uProcessorDL processorRef;				// double link field: list of processors on a cluster
+
+    uProcessorDL processorRef __attribute__(( aligned (uCacheLine()) )); // double link field: list of processors on a cluster
     uProcessorDL globalRef;				// double link field: list of all processors
 
     void createProcessor( uCluster &cluster, bool detached, int ms, int spin );
@@ -2684,7 +2851,11 @@ class uProcessor {
     } // uProcessor::idle
 
     void *operator new( size_t size ) {
-	return ::operator new( size );
+	return ::memalign( uCacheLine(), size );	// size of cache line to prevent false sharing
+    } // uProcessor::operator new
+
+    void *operator new[]( size_t size ) {
+	return ::memalign( uCacheLine(), size );	// size of cache line to prevent false sharing
     } // uProcessor::operator new
 } __attribute__(( unused )); // uProcessor
 
@@ -2720,24 +2891,21 @@ class uCluster {
     // queue and the kernel is restarted. When the kernel restarts, it now enters the critical section when it should be
     // scheduling a new task. Therefore explicit locks must be used for these queues.
 
-    friend class uBaseTask;				// access: makeTaskReady, taskAdd, taskRemove
+    friend class uBaseTask;				// access: makeTaskReady, taskAdd, taskRemove, numaPlace, defaultReadyQueue
     friend class UPP::uNBIO;				// access: makeProcessorIdle, makeProcessorActive
     friend class uEventListPop;				// access: processorsOnCluster
     friend class UPP::uNBIO::uSelectTimeoutHndlr;	// access: NBIO, wakeProcessor
     friend class UPP::uKernelBoot;			// access: new, NBIO, taskAdd, taskRemove
-    friend _Coroutine UPP::uProcessorKernel;		// access: NBIO, readyQueueTryRemove, readyQueueEmpty, tasksOnCluster, makeProcessorActive, processorPause
-    friend _Task uProcessorTask;			// access: processorAdd, processorRemove
+    friend _Coroutine UPP::uProcessorKernel;		// access: NBIO, readyQueueTryRemove, readyQueueEmpty, tasksOnCluster, makeProcessorActive, processorPause, inboxAdd
+    friend _Task uProcessorTask;			// access: processorAdd, processorRemove, numaNode, numaPolicy
     friend class uProcessor;				// access: processorAdd, processorRemove
+    friend void *uKernelModule::startThread( void *p ); // access: numaNode, numaPolicy
     friend class uRealTimeBaseTask;			// access: taskReschedule
     friend class uPeriodicBaseTask;			// access: taskReschedule
     friend class uSporadicBaseTask;			// access: taskReschedule
     friend struct uIOClosure;				// access: select
     friend class uRWLock;				// access: makeTaskReady
 
-    // must be first field for alignment
-    uSpinLock readyIdleTaskLock;			// protect readyQueue, idleProcessors and tasksOnCluster
-    uSpinLock processorsOnClusterLock;
-
     // debugging
 
     friend _Task uLocalDebugger;			// access: debugIgnore
@@ -2762,15 +2930,30 @@ class uCluster {
 	return storage;
     } // uCluster::operator new
   protected:
-    const char *name;					// textual name for cluster, default value
+    // Fields are grouped by the lock protecting them and each group starts a cache line, so processors scheduling
+    // tasks on the cluster do not invalidate the processor list and vice versa. The remaining fields are mostly read
+    // and start their own cache line. The group sizes are checked in uCluster.cc.
+
+    uKernelSpinLock readyIdleTaskLock __attribute__(( aligned (uCacheLine()) )); // protect readyQueue, idleProcessors and tasksOnCluster
     uBaseSchedule<uBaseTaskDL> *readyQueue;		// list of tasks awaiting execution by processors on this cluster
-    bool defaultReadyQueue;				// indicates if the cluster allocated the ready queue
     unsigned int idleProcessorsCnt;			// number of idle processors
     uProcessorSeq idleProcessors;			// list of idle processors associated with this cluster
     uBaseTaskSeq tasksOnCluster;			// list of tasks on this cluster
+
+    uSpinLock processorsOnClusterLock __attribute__(( aligned (uCacheLine()) )); // protect processorsOnCluster
     uProcessorSeq processorsOnCluster;			// list of processors associated with this cluster
     unsigned int numProcessors;				// number of processors on cluster
+
+    // Tasks migrating to the cluster are pushed onto the inbox without a lock, and a processor of the cluster moves
+    // all of them to the ready queue with one acquisition of readyIdleTaskLock, which also protects the histogram.
+
+    uBaseTask * volatile inbox __attribute__(( aligned (uCacheLine()) )); // stack of tasks migrating to this cluster
+    unsigned int migrationLatency[16];			// MigrationBuckets counts of migrated tasks by time in inbox
+
+    const char *name __attribute__(( aligned (uCacheLine()) )); // textual name for cluster, default value
+    bool defaultReadyQueue;				// indicates if the cluster allocated the ready queue
     unsigned int stackSize;				// default stack size for tasks created on cluster
+    int numaNode;					// NUMA node for processors, task stacks and heap, -1 => no placement
 
     uClusterDL wakeupList;				// double link field: list of clusters with wakeups
 
@@ -2791,9 +2974,12 @@ class uCluster {
     void makeProcessorActive();
 
     bool readyQueueEmpty() {
-	return readyQueue->empty();
+	return readyQueue->empty() && __atomic_load_n( &inbox, __ATOMIC_RELAXED ) == nullptr;
     } // uCluster::readyQueueEmpty
 
+    void inboxAdd( uBaseTask &task );
+    unsigned int inboxTransfer();
+
     void makeTaskReady( uBaseTask &readyTask );
     void makeTaskReady( uSequence<uBaseTaskDL> &readyQueue, unsigned int n );
     void readyQueueRemove( uBaseTaskDL *task );
@@ -2807,6 +2993,8 @@ class uCluster {
     void processorPoke();
 #endif // __U_MULTI__
     void createCluster( unsigned int stackSize, const char *name );
+    void numaPlace( void *addr, size_t len ) const;
+    static void numaPolicy( int node );
 
     int select( uIOClosure &closure, int rwe, timeval *timeout = nullptr ) {
 	return NBIO->select( closure, rwe, timeout );
@@ -2820,6 +3008,19 @@ class uCluster {
     uCluster( const char *name );
     uCluster( uBaseSchedule<uBaseTaskDL> &ReadyQueue, unsigned int stackSize = uDefaultStackSize(), const char *name = "*unnamed*" );
     uCluster( uBaseSchedule<uBaseTaskDL> &ReadyQueue, const char *name = "*unnamed*" );
+#if defined( __U_AFFINITY__ ) && defined( __linux__ )
+    // A NUMA cluster creates one detached processor bound to each core of the node, and the stacks of tasks created on
+    // the cluster and the heap storage first touched by its processors come from the node's memory. Tasks never move
+    // between clusters implicitly, so work crosses nodes only when a task explicitly migrates, e.g., to an idle node.
+
+    struct NumaNode {					// select topology-aware constructor
+	unsigned int node;
+	explicit NumaNode( unsigned int node ) : node( node ) {}
+    }; // NumaNode
+
+    uCluster( NumaNode node, unsigned int stackSize = uDefaultStackSize(), const char *name = "*unnamed*" );
+    static unsigned int numaNodes();
+#endif // __U_AFFINITY__ && __linux__
     virtual ~uCluster();
 
     const char *setName( const char *name ) {
@@ -2846,6 +3047,10 @@ class uCluster {
 	return stackSize;
     } // uCluster::getStackSize
 
+    int getNumaNode() const {
+	return numaNode;
+    } // uCluster::getNumaNode
+
     void taskResetPriority( uBaseTask &owner, uBaseTask &calling );
     void taskSetPriority( uBaseTask &owner, uBaseTask &calling );
 
@@ -2865,12 +3070,18 @@ class uCluster {
 	return numProcessors;
     } // uCluster::getProcessors
 
+    // Bucket 0 counts migrations spending less than 1 microsecond in the inbox, bucket i > 0 counts those spending
+    // [2^(i-1), 2^i) microseconds, and the last bucket counts all longer ones.
+
+    enum { MigrationBuckets = 16 };
+    void getMigrationLatency( unsigned int histogram[MigrationBuckets] );
+
     const uProcessorSeq &getProcessorsOnCluster() {
 	return processorsOnCluster;
     } // uCluster::getProcessorsOnCluster
 
     void *operator new( size_t size ) {
-	return ::memalign( 128, size );			// size of cache line to prevent false sharing
+	return ::memalign( uCacheLine(), size );	// size of cache line to prevent false sharing
     } // uCluster::operator new
 }; // uCluster
 
@@ -3064,10 +3275,16 @@ namespace UPP {
 	friend class UPP::uKernelBoot;			// access: startup, finishup
 	friend class ::uBaseTask;			// access: prepareTask
 	friend class UPP::PthreadLock;			// access: startup
+	friend _Coroutine UPP::uProcessorKernel;	// access: finishThread
+	friend _Task ::uSystemTask;			// access: purging, purgeInterval, purge
 
 	static bool traceHeap_;				// trace allocations and deallocations
 
 	static void finishup();
+	static void finishThread();
+	static bool purging();
+	static uDuration purgeInterval();
+	static void purge();
 	static void prepareTask( uBaseTask *task );
 	static void startTask();
 	static void finishTask();
@@ -34,6 +34,15 @@
 #include <uProfiler.h>
 #endif // __U_PROFILER__
 //#include <uDebug.h>
+#include <cstddef>					// offsetof
+
+#if defined( __U_AFFINITY__ ) && defined( __linux__ )
+#include <cstdio>					// snprintf
+#include <fcntl.h>					// open
+#include <unistd.h>					// read, close
+#include <sys/syscall.h>				// SYS_mbind, SYS_set_mempolicy
+#include <linux/mempolicy.h>				// MPOL_*
+#endif // __U_AFFINITY__ && __linux__
 
 
 using namespace UPP;
@@ -42,6 +51,9 @@ using namespace UPP;
 //######################### uCluster #########################
 
 
+static_assert( alignof(uCluster) == uCacheLine(), "uCluster is not cache-line aligned" );
+
+
 void uCluster::wakeProcessor( uPid_t pid __attribute__(( unused )) ) {
     uDEBUGPRT( uDebugPrt( "uCluster::wakeProcessor: waking processor %lu\n", (unsigned long)pid ); )
 
@@ -143,7 +155,11 @@ void uCluster::processorPause() {
 
 
 void uCluster::makeProcessorIdle( uProcessor &processor ) {
+#ifdef __U_QUEUELOCK__
+    assert( readyIdleTaskLock.held() );			// readyIdleTaskLock must be acquired
+#else
     assert( readyIdleTaskLock.value != 0 );		// readyIdleTaskLock must be acquired
+#endif // __U_QUEUELOCK__
     idleProcessorsCnt += 1;
     idleProcessors.addTail( &(processor.idleRef) );
 } // uCluster::makeProcessorIdle
@@ -223,7 +239,7 @@ void uCluster::makeTaskReady( uBaseTask &readyTask ) {
 
 void uCluster::makeTaskReady( uBaseTaskSeq &newTasks, unsigned int n ) {
     readyIdleTaskLock.acquire();
-    // cannot be bound task as all tasks come from RW lock
+    // cannot be bound task, bound tasks are woken individually
     uDEBUGPRT( uDebugPrt( "(uCluster &)%p.makeTaskReady(2): task %.256s (%p) tasks ready\n",
 			  this, uThisTask().getName(), &uThisTask() ); )
 
@@ -263,21 +279,117 @@ void uCluster::readyQueueRemove( uBaseTaskDL *node ) {
 
 
 uBaseTask &uCluster::readyQueueTryRemove() {
-    // Select a task from the ready queue of this cluster if there are no ready tasks, return the nil pointer.
+    // Select a task from the ready queue of this cluster if there are no ready tasks, return the nil pointer. Tasks
+    // migrating to the cluster are first moved from the inbox to the ready queue.
 
     uBaseTask *task;
 
     readyIdleTaskLock.acquire();
-    if ( ! readyQueueEmpty() ) {
+    unsigned int arrived = inboxTransfer();
+    if ( ! readyQueue->empty() ) {
 	task = &(readyQueue->drop()->task());
     } else {
 	task = nullptr;
     } // if
+#ifdef __U_MULTI__
+    // This processor runs one of the arrived tasks, so wake an idle processor for each of the others.
+
+    if ( arrived > 1 && ! idleProcessors.empty() ) {
+	uProcessorSeq restart;
+	for ( unsigned int i = 1; i < arrived && ! idleProcessors.empty(); i += 1 ) {
+	    restart.addTail( idleProcessors.dropHead() );
+	    idleProcessorsCnt -= 1;
+	} // for
+	readyIdleTaskLock.release();			// don't hold lock while sending SIGALRM
+	for ( ; ! restart.empty(); ) {
+	    uPid_t pid = restart.dropHead()->processor().pid;
+	    wakeProcessor( pid );
+	} // for
+	return *task;
+    } // if
+#endif // __U_MULTI__
     readyIdleTaskLock.release();
     return *task;
 } // uCluster::readyQueueTryRemove
 
 
+void uCluster::inboxAdd( uBaseTask &task ) {
+    // Called on the kernel stack after the migrating task has switched off its stack, so once pushed, the task can be
+    // run by a processor of this cluster. Only the push onto an empty inbox wakes an idle processor; tasks pushed
+    // before that processor drains the inbox join its batch.
+
+    assert( defaultReadyQueue );
+    task.setState( uBaseTask::Ready );			// task is marked available for execution
+    task.migrateTime = uThisProcessor().getClock().getTime();
+
+    uBaseTask *head = __atomic_load_n( &inbox, __ATOMIC_RELAXED );
+    do {
+	task.inboxNext = head;
+    } while ( ! __atomic_compare_exchange_n( &inbox, &head, &task, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED ) );
+  if ( head != nullptr ) return;			// processor already notified for this batch ?
+
+#ifdef __U_MULTI__
+    // A processor checks the inbox under readyIdleTaskLock before going idle, so either it sees this task or it is on
+    // the idle list when the lock is acquired here.
+
+    readyIdleTaskLock.acquire();
+    if ( ! idleProcessors.empty() ) {
+	uPid_t pid = idleProcessors.dropHead()->processor().pid;
+	idleProcessorsCnt -= 1;
+	readyIdleTaskLock.release();			// don't hold lock while sending SIGALRM
+	wakeProcessor( pid );
+    } else {
+	readyIdleTaskLock.release();
+    } // if
+#endif // __U_MULTI__
+} // uCluster::inboxAdd
+
+
+unsigned int uCluster::inboxTransfer() {
+    // Move all migrated tasks, in arrival order, to the cluster and its ready queue, and return the number moved.
+#ifdef __U_QUEUELOCK__
+    assert( readyIdleTaskLock.held() );			// readyIdleTaskLock must be acquired
+#else
+    assert( readyIdleTaskLock.value != 0 );		// readyIdleTaskLock must be acquired
+#endif // __U_QUEUELOCK__
+
+  if ( __atomic_load_n( &inbox, __ATOMIC_RELAXED ) == nullptr ) return 0; // do not write the inbox cache line if empty
+    uBaseTask *list = uFetchAssign( inbox, (uBaseTask *)nullptr );
+    uBaseTask *fifo = nullptr;				// inbox is LIFO
+    for ( ; list != nullptr; ) {
+	uBaseTask *next = list->inboxNext;
+	list->inboxNext = fifo;
+	fifo = list;
+	list = next;
+    } // for
+
+    uTime now = uThisProcessor().getClock().getTime();
+    unsigned int n = 0;
+    for ( ; fifo != nullptr; fifo = fifo->inboxNext ) {
+	uBaseTask &task = *fifo;
+	tasksOnCluster.addTail( &(task.clusterRef) );
+	readyQueue->addInitialize( tasksOnCluster );
+	readyQueue->add( &(task.readyRef) );
+	n += 1;
+
+	long long int ns = ( now - task.migrateTime ).nanoseconds();
+	unsigned long int us = ns <= 0 ? 0 : ns / 1000;
+	unsigned int bucket = us == 0 ? 0 : sizeof(unsigned long int) * 8 - __builtin_clzl( us );
+	migrationLatency[bucket < MigrationBuckets ? bucket : MigrationBuckets - 1] += 1;
+    } // for
+    return n;
+} // uCluster::inboxTransfer
+
+
+void uCluster::getMigrationLatency( unsigned int histogram[MigrationBuckets] ) {
+    readyIdleTaskLock.acquire();
+    for ( unsigned int i = 0; i < MigrationBuckets; i += 1 ) {
+	histogram[i] = migrationLatency[i];
+    } // for
+    readyIdleTaskLock.release();
+} // uCluster::getMigrationLatency
+
+
 void uCluster::taskAdd( uBaseTask &task ) {
     readyIdleTaskLock.acquire();
     tasksOnCluster.addTail( &(task.clusterRef) );
@@ -346,7 +458,104 @@ void uCluster::processorPoke() {
 #endif // __U_MULTI__
 
 
+#if defined( __U_AFFINITY__ ) && defined( __linux__ )
+// NUMA placement uses the mbind/set_mempolicy system calls directly rather than libnuma. Topology comes from sysfs.
+
+enum { NumaMaxNodes = 1024 };				// matches largest kernel MAX_NUMNODES
+typedef unsigned long int NumaMask[NumaMaxNodes / (8 * sizeof(unsigned long int))];
+
+static bool numaList( const char *path, cpu_set_t &set ) { // read sysfs list format, e.g., "0-3,8,10-11"
+    CPU_ZERO( &set );
+    int fd = ::open( path, O_RDONLY );
+  if ( fd == -1 ) return false;
+    char buf[4096];
+    ssize_t len = ::read( fd, buf, sizeof(buf) - 1 );
+    ::close( fd );
+  if ( len <= 0 ) return false;
+    buf[len] = '\0';
+
+    for ( char *p = buf; *p != '\0' && *p != '\n'; ) {
+	char *end;
+	unsigned int lo = strtoul( p, &end, 10 ), hi = lo;
+      if ( end == p ) break;				// malformed ?
+	p = end;
+	if ( *p == '-' ) hi = strtoul( p + 1, &p, 10 );
+	for ( unsigned int i = lo; i <= hi && i < CPU_SETSIZE; i += 1 ) CPU_SET( i, &set );
+	if ( *p == ',' ) p += 1;
+    } // for
+    return true;
+} // numaList
+
+
+static bool numaCores( unsigned int node, cpu_set_t &cores ) { // first hardware thread of each core on node
+    char path[128];
+    snprintf( path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node );
+  if ( ! numaList( path, cores ) ) return false;
+
+    for ( unsigned int cpu = 0; cpu < CPU_SETSIZE; cpu += 1 ) {
+	if ( ! CPU_ISSET( cpu, &cores ) ) continue;
+	cpu_set_t siblings;
+	snprintf( path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/thread_siblings_list", cpu );
+	if ( numaList( path, siblings ) ) {
+	    for ( unsigned int sib = cpu + 1; sib < CPU_SETSIZE; sib += 1 ) { // remove hyperthreads of this core
+		if ( CPU_ISSET( sib, &siblings ) ) CPU_CLR( sib, &cores );
+	    } // for
+	} // if
+    } // for
+    return true;
+} // numaCores
+
+
+unsigned int uCluster::numaNodes() {
+    cpu_set_t nodes;
+  if ( ! numaList( "/sys/devices/system/node/online", nodes ) ) return 1; // no NUMA support => one node
+    unsigned int cnt = 0;
+    for ( unsigned int i = 0; i < CPU_SETSIZE; i += 1 ) {
+	if ( CPU_ISSET( i, &nodes ) ) cnt = i + 1;	// node numbers are dense in practice
+    } // for
+    return cnt == 0 ? 1 : cnt;
+} // uCluster::numaNodes
+
+
+void uCluster::numaPlace( void *addr, size_t len ) const {
+  if ( numaNode < 0 ) return;				// no placement ?
+    // mbind works on whole pages, so only pages completely inside the storage are moved to the node; the partial pages
+    // at the ends are shared with adjacent heap storage and stay where they are.
+    size_t pageSize = uMachContext::pageSize;
+    uintptr_t start = uCeiling( (uintptr_t)addr, pageSize ), end = ( (uintptr_t)addr + len ) & ~( pageSize - 1 );
+  if ( start >= end ) return;
+    NumaMask mask = { 0 };
+    mask[numaNode / (8 * sizeof(unsigned long int))] |= 1ul << ( numaNode % (8 * sizeof(unsigned long int)) );
+    // Placement is only an optimization, so failure (e.g., pages pinned or node out of memory) is ignored.
+    syscall( SYS_mbind, start, end - start, MPOL_PREFERRED, mask, NumaMaxNodes + 1, MPOL_MF_MOVE );
+} // uCluster::numaPlace
+
+
+void uCluster::numaPolicy( int node ) {			// called by kernel thread of processor joining a cluster
+    if ( node < 0 ) {
+	syscall( SYS_set_mempolicy, MPOL_DEFAULT, nullptr, 0 ); // first-touch placement
+    } else {
+	NumaMask mask = { 0 };
+	mask[node / (8 * sizeof(unsigned long int))] |= 1ul << ( node % (8 * sizeof(unsigned long int)) );
+	syscall( SYS_set_mempolicy, MPOL_PREFERRED, mask, NumaMaxNodes + 1 );
+    } // if
+} // uCluster::numaPolicy
+#else
+void uCluster::numaPlace( void * /* addr */, size_t /* len */ ) const {} // no NUMA support
+void uCluster::numaPolicy( int /* node */ ) {}
+#endif // __U_AFFINITY__ && __linux__
+
+
 void uCluster::createCluster( unsigned int stackSize, const char *name ) {
+    // Each group of hot fields in uCluster starts a cache line with its lock and must fit in that line; otherwise, the
+    // group spills into the line of the next group and false sharing returns.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+    static_assert( offsetof(uCluster, processorsOnClusterLock) - offsetof(uCluster, readyIdleTaskLock) == uCacheLine(), "uCluster ready/idle fields exceed a cache line" );
+    static_assert( offsetof(uCluster, inbox) - offsetof(uCluster, processorsOnClusterLock) == uCacheLine(), "uCluster processor fields exceed a cache line" );
+    static_assert( offsetof(uCluster, name) - offsetof(uCluster, inbox) == uCacheLine(), "uCluster inbox fields exceed a cache line" );
+#pragma GCC diagnostic pop
+
     uDEBUGPRT( uDebugPrt( "(uCluster &)%p.createCluster\n", this ); )
 
 #ifdef __U_DEBUG__
@@ -361,9 +570,12 @@ void uCluster::createCluster( unsigned int stackSize, const char *name ) {
 
     numProcessors = 0;
     idleProcessorsCnt = 0;
+    inbox = nullptr;
+    for ( unsigned int i = 0; i < MigrationBuckets; i += 1 ) migrationLatency[i] = 0;
 
     setName( name );
     setStackSize( stackSize );
+    numaNode = -1;					// no NUMA placement
 
 #if __U_LOCALDEBUGGER_H__
     if ( uLocalDebugger::uLocalDebuggerActive ) uLocalDebugger::uLocalDebuggerInstance->checkPoint();
@@ -416,6 +628,25 @@ uCluster::uCluster( uBaseSchedule<uBaseTaskDL> &ReadyQueue, const char *name ) :
 } // uCluster::uCluster
 
 
+#if defined( __U_AFFINITY__ ) && defined( __linux__ )
+uCluster::uCluster( NumaNode node, unsigned int stackSize, const char *name ) : globalRef( *this ), readyQueue( nullptr ), wakeupList( *this ) {
+    createCluster( stackSize, name );
+
+    cpu_set_t cores;
+    if ( node.node >= NumaMaxNodes || ! numaCores( node.node, cores ) ) {
+	abort( "(uCluster &)%p.uCluster() : NUMA node %u does not exist.", this, node.node );
+    } // if
+    numaNode = node.node;				// set before creating processors so they adopt the node's memory policy
+    for ( unsigned int cpu = 0; cpu < CPU_SETSIZE; cpu += 1 ) {
+	if ( CPU_ISSET( cpu, &cores ) ) {
+	    uProcessor *processor = new uProcessor( *this, true ); // detached => deleted with cluster
+	    processor->setAffinity( cpu );
+	} // if
+    } // for
+} // uCluster::uCluster
+#endif // __U_AFFINITY__ && __linux__
+
+
 uCluster::~uCluster() {
     uDEBUGPRT( uDebugPrt( "(uCluster &)%p.~uCluster\n", this ); )
 
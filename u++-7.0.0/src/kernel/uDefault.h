@@ -41,6 +41,13 @@
 #define __U_DEFAULT_MMAP_START__ (512 * 1024 + 1)
 
 
+// Define the default heap huge-page mode: 0 => normal pages; 1 => heap extensions and mmapped blocks of at least a huge
+// page are aligned on 2 MB boundaries and advised to use transparent huge pages; 2 => as for 1, and this storage is
+// also pre-faulted when obtained from the operating system.
+
+#define __U_DEFAULT_HEAP_HUGE_PAGES__ 0
+
+
 // Define the default scheduling pre-emption time in milliseconds.  A scheduling pre-emption is attempted every default
 // pre-emption milliseconds.  A pre-emption does not occur if the executing task is not in user code or the task is
 // currently in a critical section.  A critical section begins when a task acquires a lock and ends when a user releases
@@ -97,8 +104,14 @@
 
 #define __U_DEFAULT_ACTOR_SEPCLUS__ false
 
+// Define the maximum number of messages an actor processes before yielding its executor thread to other actors. Must be
+// greater than 0.
+
+#define __U_DEFAULT_ACTOR_BATCH__ 64
+
 extern unsigned int uDefaultHeapExpansion();		// heap expansion size (bytes)
 extern unsigned int uDefaultMmapStart();		// cross over point to use mmap rather than buckets
+extern unsigned int uDefaultHeapHugePages();		// heap huge-page mode (0, 1 or 2)
 extern unsigned int uDefaultStackSize();		// cluster coroutine/task stack size (bytes)
 extern unsigned int uMainStackSize();			// uMain task stack size (bytes)
 extern unsigned int uDefaultSpin();			// processor spin time for idle task (context switches)
@@ -111,6 +124,7 @@ extern unsigned int uDefaultActorThreads();		// user threads servicing executor
 extern unsigned int uDefaultActorProcessors();		// kernel threads (processors) servicing executor thread-pool
 extern int uDefaultActorOffset();			// affinity and offset (-1 => no affinity, default)
 extern bool uDefaultActorSepClus();			// create processors on separate cluster
+extern unsigned int uDefaultActorBatch();		// messages processed per actor activation
 
 extern void uStatistics();				// print user defined statistics on interrupt
 
@@ -34,12 +34,18 @@
 #endif // __U_PROFILER__
 
 #include <uDebug.h>					// access: uDebugWrite
+#include <uSystemTask.h>				// access: purgeStart
 #undef __U_DEBUG_H__					// turn off debug prints
 
 #include <algorithm>
 #include <cstdio>
+#include <cstdlib>					// strtoll
 #include <cstring>
 #include <new>
+#include <cmath>					// log
+#include <csignal>					// sigaction
+#include <fcntl.h>					// open
+#include <unwind.h>					// _Unwind_Backtrace
 #include <unistd.h>					// sbrk, sysconf
 
 #define LIKELY(x)       __builtin_expect(!!(x), 1)
@@ -78,6 +84,10 @@ namespace UPP {
 #endif // FASTLOOKUP
 
     int uHeapManager::mmapFd = -1;
+    unsigned int uHeapManager::purgeDecay = 10000;	// 10 seconds
+    uHeapManager::HugePages uHeapManager::hugePages = uHeapManager::HugeOff;
+    unsigned int uHeapManager::sampleRate = 0;
+    unsigned long long int uHeapManager::sampleSeed = 0;
 #ifdef __U_DEBUG__
     unsigned long int uHeapManager::allocfree = 0;
 #endif // __U_DEBUG__
@@ -102,13 +112,50 @@ namespace UPP {
     unsigned int uHeapManager::cmemalign_calls = 0;
     unsigned long long int uHeapManager::realloc_storage = 0;
     unsigned int uHeapManager::realloc_calls = 0;
+    unsigned long long int uHeapManager::purge_storage = 0;
+    unsigned int uHeapManager::purge_calls = 0;
+    unsigned long long int uHeapManager::huge_storage = 0;
+    unsigned int uHeapManager::huge_calls = 0;
+    unsigned int uHeapManager::sample_calls = 0;
+    unsigned int uHeapManager::sample_dropped = 0;
 
     int uHeapManager::statfd = 2;			// default stderr
 
+    void uHeapManager::cacheStats( unsigned long long int & hits, unsigned long long int & refills, unsigned long long int & frees, unsigned long long int & flushes ) {
+	hits = refills = frees = flushes = 0;
+	for ( uHeapCache * cache = caches; cache != nullptr; cache = cache->next ) { // list only grows at head
+	    hits += cache->allocHits;
+	    refills += cache->allocRefills;
+	    frees += cache->freeHits;
+	    flushes += cache->freeFlushes;
+	} // for
+    } // uHeapManager::cacheStats
+
+    static long long int hugeResident() {
+	// Anonymous memory backed by huge pages, from the kernel's summary of the address space (-1 if unavailable).
+	// Read directly because malloc cannot be called.
+
+	long long int kb = -1;
+#if defined( __linux__ )
+	int fd = ::open( "/proc/self/smaps_rollup", O_RDONLY );
+      if ( fd == -1 ) return -1;
+	char buf[2048];
+	ssize_t len = ::read( fd, buf, sizeof(buf) - 1 );
+	::close( fd );
+      if ( len <= 0 ) return -1;
+	buf[len] = '\0';
+	const char * field = strstr( buf, "AnonHugePages:" );
+	if ( field != nullptr ) kb = strtoll( field + sizeof("AnonHugePages:") - 1, nullptr, 10 );
+#endif // __linux__
+	return kb == -1 ? -1 : kb * 1024;
+    } // hugeResident
+
     // Use "write" because streams may be shutdown when calls are made.
     void uHeapManager::print() {
-	char helpText[512];
-	int len = snprintf( helpText, 512, "\nHeap statistics:\n"
+	unsigned long long int hits, refills, frees, flushes;
+	heapManagerInstance->cacheStats( hits, refills, frees, flushes );
+	char helpText[1024];
+	int len = snprintf( helpText, 1024, "\nHeap statistics:\n"
 			   "  malloc: calls %u / storage %llu\n"
 			   "  calloc: calls %u / storage %llu\n"
 			   "  memalign: calls %u / storage %llu\n"
@@ -117,7 +164,12 @@ namespace UPP {
 			   "  free: calls %u / storage %llu\n"
 			   "  mmap: calls %u / storage %llu\n"
 			   "  munmap: calls %u / storage %llu\n"
-			   "  sbrk: calls %u / storage %llu\n",
+			   "  sbrk: calls %u / storage %llu\n"
+			   "  purge: calls %u / storage %llu\n"
+			   "  huge pages: calls %u / storage %llu / resident %lld\n"
+			   "  profile: samples %u / dropped %u\n"
+			   "  cache malloc: hits %llu / refills %llu / hit rate %.1f%%\n"
+			   "  cache free: hits %llu / flushes %llu / hit rate %.1f%%\n",
 			   malloc_calls, malloc_storage,
 			   calloc_calls, calloc_storage,
 			   memalign_calls, memalign_storage,
@@ -126,7 +178,12 @@ namespace UPP {
 			   free_calls, free_storage,
 			   mmap_calls, mmap_storage,
 			   munmap_calls, munmap_storage,
-			   sbrk_calls, sbrk_storage
+			   sbrk_calls, sbrk_storage,
+			   purge_calls, purge_storage,
+			   huge_calls, huge_storage, hugeResident(),
+			   sample_calls, sample_dropped,
+			   hits, refills, hits + refills == 0 ? 0.0 : 100.0 * hits / ( hits + refills ),
+			   frees, flushes, frees + flushes == 0 ? 0.0 : 100.0 * frees / ( frees + flushes )
 	    );
 	uDebugWrite( statfd, helpText, len );
     } // uHeapManager::print
@@ -161,6 +218,266 @@ namespace UPP {
 	return false;
     } // uHeapManager::setMmapStart
 
+    bool uHeapManager::setPurgeDecay( int value ) {
+      if ( value < 0 ) return true;
+	purgeDecay = value;
+	return false;
+    } // uHeapManager::setPurgeDecay
+
+    bool uHeapManager::setHugePages( int value ) {
+      if ( value < HugeOff || HugePopulate < value ) return true;
+	hugePages = (HugePages)value;			// applies to subsequent storage from the operating system
+	return false;
+    } // uHeapManager::setHugePages
+
+    void uHeapManager::hugeAdvise( void * addr, size_t size ) {
+	// Advise transparent huge pages for the whole pages of new storage, and optionally fault them in now. The
+	// advice is given first so the pre-faulting obtains huge pages.
+
+	char * start = (char *)uCeiling( (uintptr_t)addr, pageSize );
+	char * end = (char *)(((uintptr_t)addr + size) & -pageSize);
+      if ( end <= start ) return;
+#if defined( MADV_HUGEPAGE )
+	if ( madvise( start, end - start, MADV_HUGEPAGE ) == 0 ) {
+#ifdef __U_STATISTICS__
+	    uFetchAdd( huge_calls, 1 );
+	    uFetchAdd( huge_storage, end - start );
+#endif // __U_STATISTICS__
+	} // if
+#endif // MADV_HUGEPAGE
+	if ( hugePages == HugePopulate ) {
+#if defined( MADV_POPULATE_WRITE )
+	  if ( madvise( start, end - start, MADV_POPULATE_WRITE ) == 0 ) return;
+#endif // MADV_POPULATE_WRITE
+	    for ( volatile char * p = start; p < end; p += pageSize ) *p = *p; // write fault each page
+	} // if
+    } // uHeapManager::hugeAdvise
+
+    // Heap profile: sampled allocations are recorded by allocation site (call stack) in two fixed-size open-addressing
+    // tables, mapped when sampling is first enabled because the heap cannot allocate them. Entries are claimed by CAS
+    // and never move, so recording and dumping need no locks. A sampled block is marked by bit 2 of its header.
+
+    enum { SampleDepth = 32,				// maximum frames in a call stack
+	   SampleSites = 4096,				// maximum allocation sites
+	   SampleObjects = 65536,			// maximum live sampled blocks
+	   SampleProbes = 64,				// probe limit before dropping a sample
+	   Sampled = 4,					// header bit marking a sampled block
+    };
+
+    struct SampleSite {
+	uintptr_t hash;					// 0 => empty
+	volatile bool ready;				// call stack filled in
+	unsigned int depth;
+	void * pcs[SampleDepth];
+	long long int liveCnt, liveBytes, allocCnt, allocBytes;
+    }; // SampleSite
+
+    struct SampleObject {
+	uintptr_t header;				// 0 => empty, 1 => deleted
+	unsigned int site;
+	size_t size;
+    }; // SampleObject
+
+    static SampleSite * sampleSites = nullptr;
+    static SampleObject * sampleObjects = nullptr;
+    static unsigned int profileCnt = 0;			// number of profile files written on signal
+    static volatile bool profilePending = false;	// profile signal received, written at next sample
+
+    struct SampleTrace {
+	void ** pcs;
+	unsigned int depth;
+    }; // SampleTrace
+
+    static _Unwind_Reason_Code sampleFrame( struct _Unwind_Context * context, void * arg ) {
+	SampleTrace * trace = (SampleTrace *)arg;
+      if ( trace->depth == SampleDepth ) return _URC_END_OF_STACK;
+	trace->pcs[trace->depth] = (void *)_Unwind_GetIP( context );
+	trace->depth += 1;
+	return _URC_NO_REASON;
+    } // sampleFrame
+
+    static inline uintptr_t sampleHash( uintptr_t key ) {
+	key ^= key >> 33;				// murmur finalizer
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	return key;
+    } // sampleHash
+
+    bool uHeapManager::setSampleRate( int value ) {
+      if ( value < 0 ) return true;
+	if ( value != 0 && sampleSites == nullptr ) {	// first enable ?
+	    void * sites = ::mmap( 0, sizeof(SampleSite) * SampleSites, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+	  if ( sites == MAP_FAILED ) return true;
+	    void * objects = ::mmap( 0, sizeof(SampleObject) * SampleObjects, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+	    if ( objects == MAP_FAILED ) {
+		munmap( sites, sizeof(SampleSite) * SampleSites );
+		return true;
+	    } // if
+	    sampleObjects = (SampleObject *)objects;
+	    sampleSites = (SampleSite *)sites;
+	} // if
+	sampleRate = value;
+	sampleStart();					// other kernel threads draw their interval at their next allocation
+	return false;
+    } // uHeapManager::setSampleRate
+
+    long int uHeapManager::sampleNext() {
+	// Bytes to the next sample are exponentially distributed with mean sampleRate, so every allocated byte has the
+	// same chance of triggering a sample (geometric sampling).
+
+	uintptr_t rand = sampleHash( __atomic_add_fetch( &sampleSeed, 0x9e3779b97f4a7c15ULL, __ATOMIC_RELAXED ) );
+	double uniform = ( ( rand >> 11 ) + 1 ) * ( 1.0 / 9007199254740992.0 ); // (0,1]
+	return (long int)( -log( uniform ) * sampleRate ) + 1;
+    } // uHeapManager::sampleNext
+
+    void uHeapManager::sampleStart() {			// draw first sample interval for this kernel thread
+	THREAD_SETMEM( heapSampleBytes, sampleRate == 0 ? 0 : sampleNext() );
+    } // uHeapManager::sampleStart
+
+    void uHeapManager::sampleAlloc( Storage::Header * header, size_t size ) {
+	THREAD_GETMEM( This )->disableInterrupts();	// pin task to kernel thread while unwinding
+	THREAD_SETMEM( heapSampleBytes, sampleNext() );	// set first so allocations by the unwinder are not sampled
+
+	void * pcs[SampleDepth];
+	SampleTrace trace = { pcs, 0 };
+	_Unwind_Backtrace( sampleFrame, &trace );
+	uintptr_t hash = trace.depth;
+	for ( unsigned int i = 0; i < trace.depth; i += 1 ) hash = sampleHash( hash ^ (uintptr_t)pcs[i] );
+	if ( hash == 0 ) hash = 1;
+
+	// Find or claim the site for this call stack.
+
+	SampleSite * site = nullptr;
+	for ( unsigned int p = 0, i = hash % SampleSites; p < SampleProbes; p += 1, i = ( i + 1 ) % SampleSites ) {
+	    SampleSite & s = sampleSites[i];
+	    if ( s.hash == 0 && uCompareAssign( s.hash, (uintptr_t)0, hash ) ) { // claim empty entry
+		s.depth = trace.depth;
+		memcpy( s.pcs, pcs, trace.depth * sizeof(void *) );
+		__atomic_store_n( &s.ready, true, __ATOMIC_RELEASE );
+		site = &s;
+		break;
+	    } // if
+	    if ( s.hash == hash ) {
+		while ( ! __atomic_load_n( &s.ready, __ATOMIC_ACQUIRE ) ) uPause(); // claimer filling in stack
+		if ( s.depth == trace.depth && memcmp( s.pcs, pcs, trace.depth * sizeof(void *) ) == 0 ) {
+		    site = &s;
+		    break;
+		} // if
+	    } // if
+	} // for
+
+	// Record the live block so the free can find its site.
+
+	bool recorded = false;
+	if ( site != nullptr ) {
+	    uintptr_t key = (uintptr_t)header;
+	    for ( unsigned int p = 0, i = sampleHash( key ) % SampleObjects; p < SampleProbes; p += 1, i = ( i + 1 ) % SampleObjects ) {
+		SampleObject & o = sampleObjects[i];
+		uintptr_t curr = o.header;
+		if ( curr <= 1 && uCompareAssign( o.header, curr, key ) ) { // empty or deleted ?
+		    o.site = site - sampleSites;
+		    o.size = size;
+		    uFetchAdd( site->allocCnt, 1 );
+		    __atomic_fetch_add( &site->allocBytes, (long long int)size, __ATOMIC_SEQ_CST ); // uFetchAdd increment is int
+		    uFetchAdd( site->liveCnt, 1 );
+		    __atomic_fetch_add( &site->liveBytes, (long long int)size, __ATOMIC_SEQ_CST );
+		    header->kind.real.blockSize |= Sampled;
+		    recorded = true;
+		    break;
+		} // if
+	    } // for
+	} // if
+#ifdef __U_STATISTICS__
+	uFetchAdd( recorded ? sample_calls : sample_dropped, 1 );
+#endif // __U_STATISTICS__
+	if ( profilePending && uFetchAssign( profilePending, false ) ) sampleWrite(); // profile signal received ?
+	THREAD_GETMEM( This )->enableInterrupts();
+    } // uHeapManager::sampleAlloc
+
+    void uHeapManager::sampleFree( Storage::Header * header ) {
+	uintptr_t key = (uintptr_t)header;
+	for ( unsigned int p = 0, i = sampleHash( key ) % SampleObjects; p < SampleProbes; p += 1, i = ( i + 1 ) % SampleObjects ) {
+	    SampleObject & o = sampleObjects[i];
+	  if ( o.header == 0 ) break;			// not recorded ?
+	    if ( o.header == key ) {
+		SampleSite & site = sampleSites[o.site];
+		uFetchAdd( site.liveCnt, -1 );
+		__atomic_fetch_add( &site.liveBytes, -(long long int)o.size, __ATOMIC_SEQ_CST );
+		__atomic_store_n( &o.header, (uintptr_t)1, __ATOMIC_RELEASE ); // delete
+		break;
+	    } // if
+	} // for
+	header->kind.real.blockSize &= ~(size_t)Sampled;
+    } // uHeapManager::sampleFree
+
+    bool uHeapManager::sampleDump( int fd ) {
+	// Write the profile in the pprof legacy heap format (heap_v2): a line per allocation site with its sampled live
+	// and total counts and bytes, followed by the process mappings for symbolization.
+
+      if ( sampleSites == nullptr ) return true;	// sampling never enabled ?
+	long long int liveCnt = 0, liveBytes = 0, allocCnt = 0, allocBytes = 0;
+	for ( unsigned int i = 0; i < SampleSites; i += 1 ) {
+	    if ( ! sampleSites[i].ready ) continue;
+	    liveCnt += sampleSites[i].liveCnt;
+	    liveBytes += sampleSites[i].liveBytes;
+	    allocCnt += sampleSites[i].allocCnt;
+	    allocBytes += sampleSites[i].allocBytes;
+	} // for
+
+	char buf[512];
+	int len = snprintf( buf, sizeof(buf), "heap profile: %lld: %lld [%lld: %lld] @ heap_v2/%u\n",
+			    liveCnt, liveBytes, allocCnt, allocBytes, sampleRate );
+	uDebugWrite( fd, buf, len );
+	for ( unsigned int i = 0; i < SampleSites; i += 1 ) {
+	    SampleSite & site = sampleSites[i];
+	    if ( ! site.ready ) continue;
+	    len = snprintf( buf, sizeof(buf), "%lld: %lld [%lld: %lld] @", site.liveCnt, site.liveBytes, site.allocCnt, site.allocBytes );
+	    for ( unsigned int f = 0; f < site.depth; f += 1 ) {
+		if ( len > (int)sizeof(buf) - 24 ) {	// flush before overflow
+		    uDebugWrite( fd, buf, len );
+		    len = 0;
+		} // if
+		len += snprintf( buf + len, sizeof(buf) - len, " %p", site.pcs[f] );
+	    } // for
+	    buf[len] = '\n';
+	    uDebugWrite( fd, buf, len + 1 );
+	} // for
+
+	len = snprintf( buf, sizeof(buf), "\nMAPPED_LIBRARIES:\n" );
+	uDebugWrite( fd, buf, len );
+	int maps = ::open( "/proc/self/maps", O_RDONLY );
+	if ( maps != -1 ) {
+	    ssize_t cnt;
+	    while ( ( cnt = ::read( maps, buf, sizeof(buf) ) ) > 0 ) uDebugWrite( fd, buf, cnt );
+	    ::close( maps );
+	} // if
+	return false;
+    } // uHeapManager::sampleDump
+
+    void uHeapManager::sampleWrite() {
+	char name[64];
+	snprintf( name, sizeof(name), "heap.%ld.%u.prof", (long int)getpid(), uFetchAdd( profileCnt, 1 ) );
+	int fd = ::open( name, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+      if ( fd == -1 ) return;
+	sampleDump( fd );
+	::close( fd );
+    } // uHeapManager::sampleWrite
+
+    void uHeapManager::sampleSignal( int ) {
+	// snprintf is not async-signal-safe, so the handler only records the request, and the profile is written by the
+	// next sampled allocation.
+	profilePending = true;
+    } // uHeapManager::sampleSignal
+
+    bool uHeapManager::setProfileSignal( int value ) {
+      if ( value < 0 || NSIG <= value ) return true;
+	struct sigaction act;
+	sigemptyset( &act.sa_mask );
+	act.sa_flags = SA_RESTART;
+	act.sa_handler = value == 0 ? SIG_DFL : sampleSignal;
+	return value != 0 && sigaction( value, &act, nullptr ) == -1;
+    } // uHeapManager::setProfileSignal
+
     static inline void checkHeader( bool check, const char * name, void * addr ) {
 	if ( UNLIKELY( check ) ) {			// bad address ?
 	    abort( "Attempt to %s storage %p with address outside the heap.\n"
@@ -187,7 +504,7 @@ namespace UPP {
 
 	if ( UNLIKELY( heapEnd < addr ) ) {		// mmapped ?
 	    fakeHeader( header, alignment );
-	    size = header->kind.real.blockSize & -3;	// mmap size
+	    size = header->kind.real.blockSize & -7;	// mmap size, remove zero-fill and sampled flags
 	    return true;
 	} // if
 
@@ -200,7 +517,7 @@ namespace UPP {
 	checkHeader( header < heapBegin || heapEnd < header, name, addr ); // bad address ? (offset could be + or -)
 #endif // __U_DEBUG__
 
-	freeElem = (FreeHeader *)((size_t)header->kind.real.home & -3);
+	freeElem = (FreeHeader *)((size_t)header->kind.real.home & -7); // remove zero-fill and sampled flags
 #ifdef __U_DEBUG__
 	if ( freeElem < &freeLists[0] || &freeLists[NoBucketSizes] <= freeElem ) {
 	    abort( "Attempt to %s storage %p with corrupted header.\n"
@@ -222,6 +539,10 @@ namespace UPP {
 	    // If the size requested is bigger than the current remaining storage, increase the size of the heap.
 
 	    size_t increase = uCeiling( size > heapExpand ? size : heapExpand, uAlign() );
+	    char * brk = (char *)heapEnd + heapRemaining; // current end of heap
+	    if ( hugePages != HugeOff ) {		// end extension on a huge-page boundary
+		increase = uCeiling( (uintptr_t)brk + increase, HugePageSize ) - (uintptr_t)brk;
+	    } // if
 	    if ( sbrk( increase ) == (void *)-1 ) {
 		uDEBUGPRT( uDebugPrt( "0x%zx = (uHeapManager &)%p.extend( %zu ), heapBegin:%p, heapEnd:%p, heapRemaining:0x%zx, sbrk:%p\n",
 				      nullptr, this, size, heapBegin, heapEnd, heapRemaining, sbrk(0) ); )
@@ -233,6 +554,7 @@ namespace UPP {
 	    sbrk_calls += 1;
 	    sbrk_storage += increase;
 #endif // __U_STATISTICS__
+	    if ( hugePages != HugeOff ) hugeAdvise( brk, increase );
 #ifdef __U_DEBUG__
 	    // Set new memory to garbage so subsequent uninitialized usages might fail.
 	    memset( (char *)heapEnd + heapRemaining, '\377', increase );
@@ -250,6 +572,198 @@ namespace UPP {
     } // uHeapManager::extend
 
 
+    inline uHeapManager::Storage * uHeapManager::pop( FreeHeader * freeElem ) {
+	// Bucket lock must be held. Recently freed blocks are reused before purged ones, whose pages must be faulted in.
+
+	freeElem->used = true;
+	Storage *& top = freeElem->freeList != nullptr ? freeElem->freeList : freeElem->purgedList;
+	Storage * block = top;
+	if ( block != nullptr ) top = block->header.kind.real.next;
+	return block;
+    } // uHeapManager::pop
+
+    size_t uHeapManager::purge( bool all ) {
+	// For each bucket of blocks spanning at least two pages that is unused since the last pass, return the whole
+	// pages inside its free blocks to the OS, keeping the page holding the header needed for the free list. The list
+	// is detached so allocations are not delayed by the system calls.
+
+	size_t released = 0;
+	for ( unsigned int i = 0; i < maxBucketsUsed; i += 1 ) {
+	    FreeHeader * freeElem = &freeLists[i];
+	  if ( freeElem->blockSize < 2 * pageSize ) continue; // no whole pages to return ?
+	    freeElem->lock.acquire();
+	    Storage * first = nullptr;
+	    if ( all || ! freeElem->used ) {		// bucket unused for a decay interval ?
+		first = freeElem->freeList;
+		freeElem->freeList = nullptr;
+	    } // if
+	    freeElem->used = false;
+	    freeElem->lock.release();
+	  if ( first == nullptr ) continue;
+
+	    Storage * last = first;
+	    for ( Storage * p = first; p != nullptr; p = p->header.kind.real.next ) {
+		char * start = (char *)uCeiling( (uintptr_t)p->data, pageSize );
+		char * end = (char *)((uintptr_t)((char *)p + freeElem->blockSize) & -pageSize);
+		if ( start < end && madvise( start, end - start, MADV_DONTNEED ) == 0 ) {
+		    released += end - start;
+		} // if
+		last = p;
+	    } // for
+
+	    freeElem->lock.acquire();
+	    last->header.kind.real.next = freeElem->purgedList;
+	    freeElem->purgedList = first;
+	    freeElem->lock.release();
+	} // for
+#ifdef __U_STATISTICS__
+	uFetchAdd( purge_calls, 1 );
+	uFetchAdd( purge_storage, released );
+#endif // __U_STATISTICS__
+	return released;
+    } // uHeapManager::purge
+
+
+    static uHeapCache closedCache;			// sentinel: kernel thread has released its cache
+
+    uHeapCache * uHeapManager::cacheAcquire() {
+	// Reuse the cache of a terminated kernel thread, or carve a new one from the heap.
+
+	uHeapCache * cache;
+	extlock.acquire();
+	for ( cache = caches; cache != nullptr && cache->inUse; cache = cache->next );
+	if ( cache != nullptr ) cache->inUse = true;
+	extlock.release();
+	if ( cache == nullptr ) {
+	    cache = (uHeapCache *)extend( uCeiling( sizeof(uHeapCache), uAlign() ) );
+	  if ( cache == nullptr ) return nullptr;
+	    memset( (void *)cache, '\0', sizeof(uHeapCache) ); // extend may garbage fill
+	    cache->inUse = true;
+	    extlock.acquire();
+	    cache->next = caches;
+	    caches = cache;
+	    extlock.release();
+	} // if
+	return cache;
+    } // uHeapManager::cacheAcquire
+
+    void uHeapManager::cacheRelease() {
+	THREAD_GETMEM( This )->disableIntSpinLock();	// pin task to kernel thread
+	uHeapCache * cache = THREAD_GETMEM( heapCache );
+	THREAD_SETMEM( heapCache, &closedCache );	// any later requests on this kernel thread use the buckets
+	if ( cache != nullptr && cache != &closedCache ) {
+	    for ( unsigned int i = 0; i < CacheBuckets; i += 1 ) {
+		uHeapCache::Magazine & mag = cache->magazines[i];
+		if ( mag.cnt != 0 ) cacheFlush( &freeLists[i], mag.top, mag.cnt );
+		mag.cnt = 0;
+	    } // for
+	    cache->inUse = false;
+	} // if
+	THREAD_GETMEM( This )->enableIntSpinLock();
+    } // uHeapManager::cacheRelease
+
+    inline void uHeapManager::cacheFlush( FreeHeader * freeElem, Storage *& top, unsigned int cnt ) {
+	// Move the first cnt blocks of the stack to the bucket.
+
+	Storage * first = top, * last = first;
+	for ( unsigned int i = 1; i < cnt; i += 1 ) last = last->header.kind.real.next;
+	top = last->header.kind.real.next;
+	freeElem->lock.acquire();
+	last->header.kind.real.next = freeElem->freeList;
+	freeElem->freeList = first;
+	freeElem->lock.release();
+    } // uHeapManager::cacheFlush
+
+    inline uHeapManager::Storage * uHeapManager::cacheAlloc( FreeHeader * freeElem ) {
+	THREAD_GETMEM( This )->disableIntSpinLock();	// pin task to kernel thread while its cache is used
+	uHeapCache * cache = THREAD_GETMEM( heapCache );
+	if ( UNLIKELY( cache == nullptr ) ) {		// first request on this kernel thread ?
+	    cache = cacheAcquire();
+	    THREAD_SETMEM( heapCache, cache );
+	} // if
+	if ( UNLIKELY( cache == nullptr || cache == &closedCache ) ) {
+	    THREAD_GETMEM( This )->enableIntSpinLock();
+	    return nullptr;				// use bucket
+	} // if
+
+	uHeapCache::Magazine & mag = cache->magazines[freeElem - freeLists];
+	if ( UNLIKELY( mag.cnt == 0 ) ) {		// empty magazine ?
+	    // Take a batch from the bucket, or if the bucket is empty, carve a batch from the heap.
+	    freeElem->lock.acquire();
+	    Storage * first = pop( freeElem ), * last = first;
+	    unsigned int cnt = 0;
+	    if ( first != nullptr ) {
+		for ( cnt = 1; cnt < MagazineBatch; cnt += 1 ) {
+		    Storage * next = pop( freeElem );
+		  if ( next == nullptr ) break;
+		    last->header.kind.real.next = next;
+		    last = next;
+		} // for
+	    } // if
+	    freeElem->lock.release();
+
+	    if ( cnt == 0 ) {
+		size_t bsize = freeElem->blockSize;
+		first = last = (Storage *)extend( bsize * MagazineBatch ); // mutual exclusion on call
+		if ( UNLIKELY( first == nullptr ) ) {
+		    THREAD_GETMEM( This )->enableIntSpinLock();
+		    return nullptr;			// let bucket try a single block
+		} // if
+		for ( cnt = 1; cnt < MagazineBatch; cnt += 1 ) {
+		    last->header.kind.real.next = (Storage *)((char *)last + bsize);
+		    last = last->header.kind.real.next;
+		} // for
+	    } // if
+	    last->header.kind.real.next = nullptr;
+	    mag.top = first;
+	    mag.cnt = cnt;
+#ifdef __U_STATISTICS__
+	    cache->allocRefills += 1;
+	} else {
+	    cache->allocHits += 1;
+#endif // __U_STATISTICS__
+	} // if
+
+	Storage * block = mag.top;			// remove node from stack
+	mag.top = block->header.kind.real.next;
+	mag.cnt -= 1;
+	THREAD_GETMEM( This )->enableIntSpinLock();
+	return block;
+    } // uHeapManager::cacheAlloc
+
+    inline bool uHeapManager::cacheFree( FreeHeader * freeElem, Storage * block ) {
+	THREAD_GETMEM( This )->disableIntSpinLock();	// pin task to kernel thread while its cache is used
+	uHeapCache * cache = THREAD_GETMEM( heapCache );
+	if ( UNLIKELY( cache == nullptr ) ) {		// first request on this kernel thread ?
+	    cache = cacheAcquire();
+	    THREAD_SETMEM( heapCache, cache );
+	} // if
+	if ( UNLIKELY( cache == nullptr || cache == &closedCache ) ) {
+	    THREAD_GETMEM( This )->enableIntSpinLock();
+	    return false;				// use bucket
+	} // if
+
+	// A block freed by a different kernel thread than allocated it stays in the freeing thread's magazine; blocks
+	// are not owned, so imbalanced producer/consumer threads exchange storage through batched flushes and refills.
+
+	uHeapCache::Magazine & mag = cache->magazines[freeElem - freeLists];
+	if ( UNLIKELY( mag.cnt == MagazineSize ) ) {	// full magazine ?
+	    cacheFlush( freeElem, mag.top, MagazineBatch );
+	    mag.cnt -= MagazineBatch;
+#ifdef __U_STATISTICS__
+	    cache->freeFlushes += 1;
+	} else {
+	    cache->freeHits += 1;
+#endif // __U_STATISTICS__
+	} // if
+	block->header.kind.real.next = mag.top;		// push on stack
+	mag.top = block;
+	mag.cnt += 1;
+	THREAD_GETMEM( This )->enableIntSpinLock();
+	return true;
+    } // uHeapManager::cacheFree
+
+
     inline void * uHeapManager::doMalloc( size_t size ) {
 	uDEBUGPRT( uDebugPrt( "(uHeapManager &)%p.doMalloc( %zu )\n", this, size ); )
 
@@ -271,28 +785,31 @@ namespace UPP {
 
 	    uDEBUGPRT( uDebugPrt( "(uHeapManager &)%p.doMalloc, size after lookup:%zu\n", this, tsize ); )
     
-	    // Spin until the lock is acquired for this particular size of block.
+	    // Take a block from this kernel thread's magazine, otherwise spin until the lock is acquired for this
+	    // particular size of block.
 
+	    block = freeElem < &freeLists[CacheBuckets] ? cacheAlloc( freeElem ) : nullptr;
+	    if ( UNLIKELY( block == nullptr ) ) {	// not cached ?
 #if defined( SPINLOCK )
-	    freeElem->lock.acquire();
-	    block = freeElem->freeList;			// remove node from stack
+		freeElem->lock.acquire();
+		block = pop( freeElem );		// remove node from stack
 #else
-	    block = freeElem->freeList.pop();
+		block = freeElem->freeList.pop();
 #endif // SPINLOCK
-	    if ( UNLIKELY( block == nullptr ) ) {	// no free block ?
+		if ( UNLIKELY( block == nullptr ) ) {	// no free block ?
 #if defined( SPINLOCK )
-		freeElem->lock.release();
+		    freeElem->lock.release();
 #endif // SPINLOCK
-		// Freelist for that size was empty, so carve it out of the heap if there's enough left, or get some more
-		// and then carve it off.
+		    // Freelist for that size was empty, so carve it out of the heap if there's enough left, or get some
+		    // more and then carve it off.
 
-		block = (Storage *)extend( tsize );	// mutual exclusion on call
-		if ( UNLIKELY( block == nullptr ) ) return nullptr;
+		    block = (Storage *)extend( tsize );	// mutual exclusion on call
+		    if ( UNLIKELY( block == nullptr ) ) return nullptr;
 #if defined( SPINLOCK )
-	    } else {
-		freeElem->freeList = block->header.kind.real.next;
-		freeElem->lock.release();
+		} else {
+		    freeElem->lock.release();
 #endif // SPINLOCK
+		} // if
 	    } // if
 
 	    block->header.kind.real.home = freeElem;	// pointer back to free list of apropriate size
@@ -308,10 +825,28 @@ namespace UPP {
 #else
 		MAP_ANONYMOUS;
 #endif
-	    block = (Storage *)::mmap( 0, tsize, PROT_READ | PROT_WRITE, mmapFlags, mmapFd, 0 );
-	    if ( block == MAP_FAILED ) {
-		// Do not call strerror( errno ) as it may call malloc.
-		abort( "(uHeapManager &)0x%p.doMalloc() : internal error, mmap failure, size:%zu error:%d.", this, tsize, errno );
+	    if ( hugePages != HugeOff && tsize >= HugePageSize ) { // huge block ?
+		// Over-allocate by a huge page to align the block on a huge-page boundary, and unmap the excess at both
+		// ends so the block is exactly the mapping freed by munmap.
+		char * map = (char *)::mmap( 0, tsize + HugePageSize, PROT_READ | PROT_WRITE, mmapFlags, mmapFd, 0 );
+		if ( map == MAP_FAILED ) {
+		    // Do not call strerror( errno ) as it may call malloc.
+		    abort( "(uHeapManager &)0x%p.doMalloc() : internal error, mmap failure, size:%zu error:%d.", this, tsize, errno );
+		} // if
+		char * aligned = (char *)uCeiling( (uintptr_t)map, HugePageSize );
+		if ( aligned != map ) munmap( map, aligned - map );
+		munmap( aligned + tsize, map + HugePageSize - aligned );
+		block = (Storage *)aligned;
+		hugeAdvise( block, tsize );
+	    } else {
+#if defined( MAP_POPULATE )
+		if ( hugePages == HugePopulate ) mmapFlags |= MAP_POPULATE; // pre-fault small pages
+#endif // MAP_POPULATE
+		block = (Storage *)::mmap( 0, tsize, PROT_READ | PROT_WRITE, mmapFlags, mmapFd, 0 );
+		if ( block == MAP_FAILED ) {
+		    // Do not call strerror( errno ) as it may call malloc.
+		    abort( "(uHeapManager &)0x%p.doMalloc() : internal error, mmap failure, size:%zu error:%d.", this, tsize, errno );
+		} // if
 	    } // if
 #ifdef __U_DEBUG__
 	    // Set new memory to garbage so subsequent uninitialized usages might fail.
@@ -322,6 +857,17 @@ namespace UPP {
 
 	void * area = &(block->data);			// adjust off header to user bytes
 
+	if ( UNLIKELY( sampleRate != 0 ) ) {		// heap profiling ?
+	    long int countdown = THREAD_GETMEM( heapSampleBytes );
+	    // A countdown is never left at zero, so zero means this kernel thread was running before sampling was
+	    // enabled and has not drawn its first interval. Drawing it now, rather than sampling, keeps the first
+	    // allocation of such a kernel thread from being sampled.
+	    if ( UNLIKELY( countdown == 0 ) ) countdown = sampleNext();
+	    countdown -= tsize;
+	    THREAD_SETMEM( heapSampleBytes, countdown );
+	    if ( UNLIKELY( countdown <= 0 ) ) sampleAlloc( &block->header, size );
+	} // if
+
 #ifdef __U_DEBUG__
 	assert( ((uintptr_t)area & (uAlign() - 1)) == 0 ); // minimum alignment ?
 	uFetchAdd( uHeapManager::allocfree, tsize );
@@ -338,6 +884,48 @@ namespace UPP {
 	return area;
     } // uHeapManager::doMalloc
 
+    inline void uHeapManager::freeBucket( void * addr __attribute__(( unused )), Storage::Header * header, FreeHeader * freeElem ) {
+#ifdef __U_PROFILER__
+	if ( uThisTask().profileActive && uProfiler::uProfiler_registerMemoryDeallocate ) {
+	    (* uProfiler::uProfiler_registerMemoryDeallocate)( uProfiler::profilerInstance, addr, freeElem->blockSize, PROFILEMALLOCENTRY( header ) ); 
+	} // if
+#endif // __U_PROFILER__
+
+#ifdef __U_DEBUG__
+	// Set free memory to garbage so subsequent usages might fail.
+	memset( ((Storage *)header)->data, '\377', freeElem->blockSize - sizeof( Storage ) );
+#endif // __U_DEBUG__
+
+	uDEBUGPRT( uDebugPrt( "(uHeapManager &)%p.freeBucket( %p ) header:%p freeElem:%p\n", this, addr, &header, &freeElem ); )
+
+#ifdef __U_STATISTICS__
+	free_storage += freeElem->blockSize;
+#endif // __U_STATISTICS__
+	if ( freeElem >= &freeLists[CacheBuckets] || ! cacheFree( freeElem, (Storage *)header ) ) { // not cached ?
+#if defined( SPINLOCK )
+	    freeElem->lock.acquire();			// acquire spin lock
+	    header->kind.real.next = freeElem->freeList; // push on stack
+	    freeElem->freeList = (Storage *)header;
+	    freeElem->lock.release();			// release spin lock
+#else	    
+	    freeElem->freeList.push( *(Storage *)header );
+#endif // SPINLOCK
+	} // if
+	uDEBUGPRT( uDebugPrt( "(uHeapManager &)%p.freeBucket( %p ) returning free block in list 0x%zx\n", this, addr, freeElem->blockSize ); )
+    } // uHeapManager::freeBucket
+
+    inline void uHeapManager::traceFree( void * addr __attribute__(( unused )), size_t size __attribute__(( unused )) ) {
+#ifdef __U_DEBUG__
+	uFetchAdd( uHeapManager::allocfree, -size );
+	if ( uHeapControl::traceHeap() ) {
+	    enum { BufferSize = 64 };
+	    char helpText[BufferSize];
+	    int len = snprintf( helpText, BufferSize, "Free( %p ) size:%zu\n", addr, size );
+	    uDebugWrite( STDERR_FILENO, helpText, len );
+	} // if
+#endif // __U_DEBUG__
+    } // uHeapManager::traceFree
+
     inline void uHeapManager::doFree( void * addr ) {
 	uDEBUGPRT( uDebugPrt( "(uHeapManager &)%p.doFree( %p )\n", this, addr ); )
 
@@ -351,7 +939,9 @@ namespace UPP {
 	FreeHeader * freeElem;
 	size_t size, alignment;				// not used (see realloc)
 
-	if ( headers( "free", addr, header, freeElem, size, alignment ) ) { // mmapped ?
+	bool mapped = headers( "free", addr, header, freeElem, size, alignment );
+	if ( UNLIKELY( header->kind.real.blockSize & Sampled ) ) sampleFree( header ); // heap profiled ?
+	if ( mapped ) {					// mmapped ?
 #ifdef __U_STATISTICS__
 	    uFetchAdd( munmap_calls, 1 );
 	    uFetchAdd( munmap_storage, size );
@@ -364,43 +954,101 @@ namespace UPP {
 #endif // __U_DEBUG__
 	    } // if
 	} else {
-#ifdef __U_PROFILER__
-	    if ( uThisTask().profileActive && uProfiler::uProfiler_registerMemoryDeallocate ) {
-		(* uProfiler::uProfiler_registerMemoryDeallocate)( uProfiler::profilerInstance, addr, freeElem->blockSize, PROFILEMALLOCENTRY( header ) ); 
-	    } // if
-#endif // __U_PROFILER__
+	    freeBucket( addr, header, freeElem );
+	} // if
+	traceFree( addr, size );
+    } // uHeapManager::doFree
+
+    inline void uHeapManager::doFreeSized( void * addr, size_t size ) {
+	// The allocation size selects the bucket without decoding the header, which is only compared with the bucket.
+	// A mismatch means the block is mmapped, aligned (fake header), sampled, or was shrunk in place by realloc, and
+	// the general path is taken.
 
 #ifdef __U_DEBUG__
-	    // Set free memory to garbage so subsequent usages might fail.
-	    memset( ((Storage *)header)->data, '\377', freeElem->blockSize - sizeof( Storage ) );
+	if ( uHeapManager::heapManagerInstance == nullptr ) {
+	    abort( "uHeapManager::doFreeSized( %p, %zu ) : internal error, called before heap is initialized.", addr, size );
+	} // if
+	{
+	    Storage::Header * header;			// check address and header before trusting the size
+	    FreeHeader * freeElem;
+	    size_t bsize, alignment;
+	    headers( "free_sized", addr, header, freeElem, bsize, alignment );
+	}
 #endif // __U_DEBUG__
 
-	    uDEBUGPRT( uDebugPrt( "(uHeapManager &)%p.doFree( %p ) header:%p freeElem:%p\n", this, addr, &header, &freeElem ); )
+	size_t tsize = size + sizeof(Storage);
+	if ( LIKELY( tsize < mmapStart && addr <= heapEnd ) ) {
+	    FreeHeader * freeElem =
+#ifdef FASTLOOKUP
+		tsize < LookupSizes ? &freeLists[lookup[tsize]] :
+#endif // FASTLOOKUP
+		std::lower_bound( freeLists, freeLists + maxBucketsUsed, tsize ); // binary search
+	    Storage::Header * header = headerAddr( addr );
+	    if ( LIKELY( (FreeHeader *)((size_t)header->kind.real.home & -3) == freeElem ) ) { // ignore zero-fill flag
+		freeBucket( addr, header, freeElem );
+		traceFree( addr, freeElem->blockSize );
+		return;
+	    } // if
+	} // if
+	doFree( addr );
+    } // uHeapManager::doFreeSized
+
+    void uHeapManager::doFreeBulk( void * addrs[], size_t n ) {
+	// Consecutive blocks from the same bucket are chained and pushed onto the bucket's free list with one lock
+	// acquisition, bypassing the kernel-thread magazines, which are too small for large batches.
 
+	FreeHeader * chainElem = nullptr;
+	Storage * first = nullptr, * last = nullptr;
 #ifdef __U_STATISTICS__
-	    free_storage += size;
+	unsigned int frees = 0;				// null entries are not frees
 #endif // __U_STATISTICS__
-#if defined( SPINLOCK )
-	    freeElem->lock.acquire();			// acquire spin lock
-	    header->kind.real.next = freeElem->freeList; // push on stack
-	    freeElem->freeList = (Storage *)header;
-	    freeElem->lock.release();			// release spin lock
-#else	    
-	    freeElem->freeList.push( *(Storage *)header );
-#endif // SPINLOCK
-	    uDEBUGPRT( uDebugPrt( "(uHeapManager &)%p.doFree( %p ) returning free block in list 0x%zx\n", this, addr, size ); )
-	} // if
-
+	for ( size_t i = 0; i <= n; i += 1 ) {
+	    Storage::Header * header = nullptr;
+	    FreeHeader * freeElem = nullptr;		// nullptr => end of batch
+	    size_t size = 0, alignment;
+	    if ( i < n ) {
+		void * addr = addrs[i];
+	      if ( addr == nullptr ) continue;
+#ifdef __U_STATISTICS__
+		frees += 1;
+#endif // __U_STATISTICS__
+		if ( headers( "free_bulk", addr, header, freeElem, size, alignment ) || ( header->kind.real.blockSize & Sampled )
+#ifdef __U_PROFILER__
+		     || uThisTask().profileActive
+#endif // __U_PROFILER__
+		    ) {
+		    doFree( addr );			// rare cases use general path
+		    continue;
+		} // if
 #ifdef __U_DEBUG__
-	uFetchAdd( uHeapManager::allocfree, -size );
-	if ( uHeapControl::traceHeap() ) {
-	    enum { BufferSize = 64 };
-	    char helpText[BufferSize];
-	    int len = snprintf( helpText, BufferSize, "Free( %p ) size:%zu\n", addr, size );
-	    uDebugWrite( STDERR_FILENO, helpText, len );
-	} // if
+		memset( ((Storage *)header)->data, '\377', freeElem->blockSize - sizeof( Storage ) ); // scrub
 #endif // __U_DEBUG__
-    } // uHeapManager::doFree
+#ifdef __U_STATISTICS__
+		free_storage += size;
+#endif // __U_STATISTICS__
+		traceFree( addr, size );
+	    } // if
+
+	    if ( freeElem != chainElem ) {		// bucket changes ?
+		if ( first != nullptr ) {		// push chain for previous bucket
+		    chainElem->lock.acquire();
+		    last->header.kind.real.next = chainElem->freeList;
+		    chainElem->freeList = first;
+		    chainElem->lock.release();
+		} // if
+		chainElem = freeElem;
+		first = last = nullptr;
+	    } // if
+	    if ( header != nullptr ) {
+		header->kind.real.next = first;		// add to chain
+		if ( last == nullptr ) last = (Storage *)header;
+		first = (Storage *)header;
+	    } // if
+	} // for
+#ifdef __U_STATISTICS__
+	uFetchAdd( free_calls, frees );
+#endif // __U_STATISTICS__
+    } // uHeapManager::doFreeBulk
 
 
     size_t uHeapManager::checkFree( bool prt ) {
@@ -415,6 +1063,12 @@ namespace UPP {
 	    unsigned int N = 0;
 #endif // __U_STATISTICS__
 #if defined( SPINLOCK )
+	    for ( Storage * p = freeLists[i].purgedList; p != nullptr; p = p->header.kind.real.next ) {
+		total += size;
+#ifdef __U_STATISTICS__
+		N += 1;
+#endif // __U_STATISTICS__
+	    } // for
 	    for ( Storage * p = freeLists[i].freeList; p != nullptr; p = p->header.kind.real.next ) {
 #else
 	    for ( Storage * p = freeLists[i].freeList.top(); p != nullptr; p = p->header.kind.real.next.top ) {
@@ -424,6 +1078,14 @@ namespace UPP {
 		N += 1;
 #endif // __U_STATISTICS__
 	    } // for
+	    if ( i < CacheBuckets ) {			// include blocks in kernel-thread magazines
+		for ( uHeapCache * cache = caches; cache != nullptr; cache = cache->next ) {
+		    total += size * cache->magazines[i].cnt;
+#ifdef __U_STATISTICS__
+		    N += cache->magazines[i].cnt;
+#endif // __U_STATISTICS__
+		} // for
+	    } // if
 #ifdef __U_STATISTICS__
 	    if ( prt ) uDebugPrt2( "%7zu, %-7u  ", size, N );
 	    if ( (i + 1) % 8 == 0 ) uDebugPrt2( "\n" );
@@ -457,6 +1119,9 @@ namespace UPP {
 	    abort( "uHeapManager::uHeapManager : internal error, mmap start initialization failure." );
 	} // if
 	heapExpand = uDefaultHeapExpansion();
+	if ( setHugePages( uDefaultHeapHugePages() ) ) {
+	    abort( "uHeapManager::uHeapManager : uDefaultHeapHugePages must return 0, 1 or 2." );
+	} // if
 
 	char * end = (char *)sbrk( 0 );
 	sbrk( (char *)uCeiling( (long unsigned int)end, uAlign() ) - end ); // move start of heap to multiple of alignment
@@ -545,6 +1210,40 @@ namespace UPP {
 	uHeapManager::heapManagerInstance->uHeapManager::~uHeapManager();
     } // uHeapControl::finishup
 
+    void uHeapControl::finishThread() {
+	// Called by a terminating kernel thread to return its cached blocks for use by the other kernel threads.
+
+	if ( uHeapManager::heapManagerInstance != nullptr ) {
+	    uHeapManager::heapManagerInstance->cacheRelease();
+	} // if
+    } // uHeapControl::finishThread
+
+    static uTime purgeNext;				// time of next purge pass
+
+    bool uHeapControl::purging() {			// system task waits for purge pass ?
+	return uHeapManager::purgeDecay != 0;
+    } // uHeapControl::purging
+
+    uDuration uHeapControl::purgeInterval() {
+	// Time remaining to the next purge pass, so other requests to the system task do not postpone purging. Only
+	// called while purging is on.
+
+	uTime now = uThisProcessor().getClock().getTime();
+	if ( purgeNext <= now ) {
+	    unsigned int decay = uHeapManager::purgeDecay;
+	    purgeNext = now + uDuration( decay / 1000, decay % 1000 * 1000000 );
+	} // if
+	return purgeNext - now;
+    } // uHeapControl::purgeInterval
+
+    void uHeapControl::purge() {
+	// Called by the system task when the purge interval expires.
+
+	if ( uHeapManager::purgeDecay != 0 && uHeapManager::heapManagerInstance != nullptr ) {
+	    uHeapManager::heapManagerInstance->purge( false );
+	} // if
+    } // uHeapControl::purge
+
     void uHeapControl::prepareTask( uBaseTask * /* task */ ) {
     } // uHeapControl::prepareTask
 
@@ -566,7 +1265,7 @@ namespace UPP {
 #ifdef __U_PROFILER__
 	if ( uThisTask().profileActive && uProfiler::uProfiler_registerMemoryAllocate ) {
 	    UPP::uHeapManager::Storage::Header * header = headerAddr( area );
-	    PROFILEMALLOCENTRY( header ) = (* uProfiler::uProfiler_registerMemoryAllocate)( uProfiler::profilerInstance, area, size, header->kind.real.blockSize & -3 );
+	    PROFILEMALLOCENTRY( header ) = (* uProfiler::uProfiler_registerMemoryAllocate)( uProfiler::profilerInstance, area, size, header->kind.real.blockSize & -7 );
 	} // if
 #endif // __U_PROFILER__
 	return area;
@@ -607,7 +1306,7 @@ namespace UPP {
 
 #ifdef __U_PROFILER__
 	if ( uThisTask().profileActive && uProfiler::uProfiler_registerMemoryAllocate ) {
-	    PROFILEMALLOCENTRY( fakeHeader ) = (* uProfiler::uProfiler_registerMemoryAllocate)( uProfiler::profilerInstance, area, size, realHeader->kind.real.home->blockSize & -3 );
+	    PROFILEMALLOCENTRY( fakeHeader ) = (* uProfiler::uProfiler_registerMemoryAllocate)( uProfiler::profilerInstance, area, size, ((FreeHeader *)((size_t)realHeader->kind.real.home & -7))->blockSize );
 	} // if
 #endif // __U_PROFILER__
 
@@ -782,6 +1481,27 @@ extern "C" {
     } // free
 
 
+    void free_sized( void * addr, size_t size ) __THROW {
+	// size must be the size passed to malloc, calloc or realloc for this storage.
+
+#ifdef __U_STATISTICS__
+	uFetchAdd( UPP::uHeapManager::free_calls, 1 );
+#endif // __U_STATISTICS__
+      if ( UNLIKELY( addr == nullptr ) ) return;	// special case
+	UPP::uHeapManager::heapManagerInstance->doFreeSized( addr, size );
+	uDEBUGPRT( uDebugPrt( "free_sized( %p, %zu )\n", addr, size ); )
+    } // free_sized
+
+
+    void free_bulk( void * addrs[], size_t n ) __THROW {
+	// Free n blocks, some of which may be null; grouping blocks of the same size gives the largest benefit.
+
+      if ( UNLIKELY( n == 0 ) ) return;
+	UPP::uHeapManager::heapManagerInstance->doFreeBulk( addrs, n );
+	uDEBUGPRT( uDebugPrt( "free_bulk( %p, %zu )\n", addrs, n ); )
+    } // free_bulk
+
+
     size_t malloc_alignment( void * addr ) __THROW {
       if ( UNLIKELY( addr == nullptr ) ) return uAlign(); // minimum alignment
 	UPP::uHeapManager::Storage::Header * header = (UPP::uHeapManager::Storage::Header *)( (char *)addr - sizeof(UPP::uHeapManager::Storage) );
@@ -852,14 +1572,55 @@ extern "C" {
 	  case M_MMAP_THRESHOLD:
 	    if ( UPP::uHeapManager::heapManagerInstance->setMmapStart( value ) ) return 1;
 	    break;
+	  case M_PURGE_DECAY:
+	    if ( value > 0 && UPP::uHeapManager::purgeDecay == 0 && uKernelModule::systemTask != nullptr ) { // purging turned on ?
+		UPP::uHeapManager::setPurgeDecay( value );
+		uKernelModule::systemTask->purgeStart(); // system task has no purge timeout while purging is off
+	    } else if ( UPP::uHeapManager::setPurgeDecay( value ) ) return 1;
+	    break;
+	  case M_HUGE_PAGES:
+	    if ( UPP::uHeapManager::setHugePages( value ) ) return 1;
+	    break;
+	  case M_SAMPLE_RATE:
+	    if ( UPP::uHeapManager::setSampleRate( value ) ) return 1;
+	    break;
+	  case M_PROFILE_SIGNAL:
+	    if ( UPP::uHeapManager::setProfileSignal( value ) ) return 1;
+	    break;
 	  default:
 	    return 1;
 	} // switch
 	return 0;
     } // mallopt
+
+
+    int malloc_trim( size_t /* pad */ ) __THROW {
+	// Return the pages of all free bucket blocks to the OS immediately; the top pad is meaningless for this heap.
+
+	if ( UPP::uHeapManager::heapManagerInstance == nullptr ) return 0;
+	return UPP::uHeapManager::heapManagerInstance->purge( true ) != 0;
+    } // malloc_trim
+
+
+    int malloc_profile( int fd ) __THROW {
+	// Write the sampled heap profile (see M_SAMPLE_RATE) in pprof format; -1 if sampling was never enabled.
+
+	return UPP::uHeapManager::sampleDump( fd ) ? -1 : 0;
+    } // malloc_profile
 } // extern "C"
 
 
+// Sized deallocation (C++14) knows the block size, so the bucket is found without decoding the header.
+
+void operator delete( void * addr, std::size_t size ) noexcept {
+    free_sized( addr, size );
+} // operator delete
+
+void operator delete[]( void * addr, std::size_t size ) noexcept {
+    free_sized( addr, size );
+} // operator delete[]
+
+
 // Local Variables: //
 // compile-command: "make install" //
 // End: //
@@ -46,18 +46,23 @@ extern "C" {
     void * memalign( size_t alignment, size_t size ) __THROW;
     void * valloc( size_t size ) __THROW;
     void free( void * addr ) __THROW;
+    void free_sized( void * addr, size_t size ) __THROW;
+    void free_bulk( void * addrs[], size_t n ) __THROW;
     size_t malloc_alignment( void * addr ) __THROW;
     bool malloc_zero_fill( void * addr ) __THROW;
     size_t malloc_usable_size( void * addr ) __THROW;
     void malloc_stats() __THROW;
     int malloc_stats_fd( int fd ) __THROW;
     int mallopt( int param_number, int value ) __THROW;
+    int malloc_trim( size_t pad ) __THROW;
+    int malloc_profile( int fd ) __THROW;
 } // extern "C"
 
 
 namespace UPP {
     class uHeapManager {
 	friend class uKernelBoot;			// access: uHeap
+	friend class ::uKernelModule;			// access: sampleStart
 	friend class UPP::uMachContext;			// access: pageSize
 	friend class UPP::uSigHandlerModule;		// access: print
 	friend void * ::malloc( size_t size ) __THROW;	// access: boot
@@ -67,7 +72,11 @@ namespace UPP {
 	friend void * ::memalign( size_t alignment, size_t size ) __THROW; // access: boot
 	friend void * ::valloc( size_t size ) __THROW;	// access: pageSize
 	friend void ::free( void * addr ) __THROW;	// access: doFree
-	friend int ::mallopt( int param_number, int value ) __THROW; // access: heapManagerInstance, setHeapExpand, setMmapStart
+	friend void ::free_sized( void * addr, size_t size ) __THROW; // access: doFreeSized
+	friend void ::free_bulk( void * addrs[], size_t n ) __THROW; // access: doFreeBulk
+	friend int ::mallopt( int param_number, int value ) __THROW; // access: heapManagerInstance, setHeapExpand, setMmapStart, setPurgeDecay, setHugePages, setSampleRate, setProfileSignal
+	friend int ::malloc_profile( int fd ) __THROW;	// access: sampleDump
+	friend int ::malloc_trim( size_t pad ) __THROW;	// access: heapManagerInstance, purge
 	friend bool ::malloc_zero_fill( void * addr ) __THROW; // access: Storage
 	// paraenthesis required for typedef
 	friend size_t (::malloc_alignment)( void * addr ) __THROW; // access: Header, FreeHeader
@@ -75,6 +84,7 @@ namespace UPP {
 	friend void ::malloc_stats() __THROW;
 	friend int ::malloc_stats_fd( int fd ) __THROW;
 	friend class uHeapControl;			// access: heapManagerInstance, boot
+	friend struct uHeapCache;			// access: Storage, CacheBuckets
 	#ifdef __U_STATISTICS__
 	friend void UPP::Statistics::print();
 	#endif // __U_STATISTICS__
@@ -135,7 +145,9 @@ namespace UPP {
 	struct FreeHeader {
 	    #if BUCKLOCK == SPINLOCK
 	    uSpinLock lock;				// must be first field for alignment
-	    Storage * freeList;
+	    Storage * freeList;				// recently freed blocks
+	    Storage * purgedList;			// free blocks whose pages are returned to the OS
+	    bool used;					// blocks taken since last purge pass
 	    #elif BUCKLOCK == LOCKFREE
 	    StackLF<Storage> freeList;
 	    #else
@@ -150,8 +162,14 @@ namespace UPP {
 	       #ifdef FASTLOOKUP
 	       LookupSizes = 65536,			// number of fast lookup sizes
 	       #endif // FASTLOOKUP
+	       CacheBuckets = 21,			// buckets up to 1024 bytes are cached per kernel thread
+	       MagazineSize = 32,			// maximum free blocks cached per bucket
+	       MagazineBatch = 16,			// free blocks moved to/from a bucket at a time
 	};
 
+	enum HugePages { HugeOff, HugeAdvise, HugePopulate }; // values of uDefaultHeapHugePages and M_HUGE_PAGES
+	enum { HugePageSize = 2 * 1024 * 1024 };	// transparent huge-page size
+
 	static uHeapManager * heapManagerInstance;	// pointer to heap manager object
 	static size_t pageSize;				// architecture pagesize
 	static size_t heapExpand;			// sbrk advance
@@ -162,6 +180,10 @@ namespace UPP {
 	static unsigned char lookup[LookupSizes];	// O(1) lookup for small sizes
 	#endif // FASTLOOKUP
 	static int mmapFd;				// fake or actual fd for anonymous file
+	static unsigned int purgeDecay;			// milliseconds a bucket is unused before its pages are purged, 0 => never
+	static HugePages hugePages;			// back storage with transparent huge pages
+	static unsigned int sampleRate;			// mean bytes allocated between heap-profile samples, 0 => off
+	static unsigned long long int sampleSeed;	// random sample intervals
 	#ifdef __U_DEBUG__
 	static unsigned long int allocfree;		// running total of allocations minus frees
 	#endif // __U_DEBUG__
@@ -186,8 +208,15 @@ namespace UPP {
 	static unsigned int cmemalign_calls;
 	static unsigned long long int realloc_storage;
 	static unsigned int realloc_calls;
+	static unsigned long long int purge_storage;
+	static unsigned int purge_calls;
+	static unsigned long long int huge_storage;
+	static unsigned int huge_calls;
+	static unsigned int sample_calls;
+	static unsigned int sample_dropped;
 	static int statfd;
 	static void print();
+	void cacheStats( unsigned long long int & hits, unsigned long long int & refills, unsigned long long int & frees, unsigned long long int & flushes );
 	#endif // __U_STATISTICS__
 
 	// The next variables are statically allocated => zero filled.
@@ -199,6 +228,7 @@ namespace UPP {
 	void * heapBegin;				// start of heap
 	void * heapEnd;					// logical end of heap
 	size_t heapRemaining;				// amount of storage not allocated in the current chunk
+	uHeapCache * caches;				// all kernel-thread caches, in use or spare (protected by extlock)
 
 	static void boot();
 	static void noMemory();				// called by "builtin_new" when malloc returns 0
@@ -206,13 +236,36 @@ namespace UPP {
 	static void checkAlign( size_t alignment );
 	static bool setHeapExpand( size_t value );
 	static bool setMmapStart( size_t value );
+	static bool setPurgeDecay( int value );
+	static bool setHugePages( int value );
+	static void hugeAdvise( void * addr, size_t size );
+	static bool setSampleRate( int value );
+	static bool setProfileSignal( int value );
+	static long int sampleNext();
+	static void sampleStart();
+	static void sampleAlloc( Storage::Header * header, size_t size );
+	static void sampleFree( Storage::Header * header );
+	static bool sampleDump( int fd );
+	static void sampleWrite();
+	static void sampleSignal( int sig );
 
 	bool headers( const char * name, void * addr, Storage::Header *& header, FreeHeader *& freeElem, size_t & size, size_t & alignment );
 	void * extend( size_t size );
+	uHeapCache * cacheAcquire();
+	void cacheRelease();
+	Storage * cacheAlloc( FreeHeader * freeElem );
+	bool cacheFree( FreeHeader * freeElem, Storage * block );
+	void cacheFlush( FreeHeader * freeElem, Storage *& top, unsigned int cnt );
+	static Storage * pop( FreeHeader * freeElem );
+	size_t purge( bool all );
 	void * doMalloc( size_t size );
 	static void * malloc2( size_t size ) __THROW;
 	static void * memalign2( size_t alignment, size_t size ) __THROW;
 	void doFree( void * addr );
+	void doFreeSized( void * addr, size_t size );
+	void doFreeBulk( void * addrs[], size_t n );
+	void freeBucket( void * addr, Storage::Header * header, FreeHeader * freeElem );
+	static void traceFree( void * addr, size_t size );
 	size_t checkFree( bool prt = false );
 	uHeapManager();
 	~uHeapManager();
@@ -221,6 +274,25 @@ namespace UPP {
 	void * operator new( size_t size );
       public:
     }; // uHeapManager
+
+
+    // Each kernel thread (and hence each uProcessor) has a magazine of free blocks for each of the small bucket sizes,
+    // so most allocations and frees touch no shared data. An empty magazine is refilled, and a full one flushed, a
+    // batch at a time under a single acquisition of the bucket lock. Caches are never freed; the cache of a terminated
+    // kernel thread is flushed and reused by the next kernel thread.
+
+    struct uHeapCache {
+	struct Magazine {
+	    uHeapManager::Storage * top;		// stack of free blocks linked through the header
+	    unsigned int cnt;				// number of blocks on stack
+	} magazines[uHeapManager::CacheBuckets];
+	uHeapCache * next;				// list of all caches
+	bool inUse;					// owned by a kernel thread
+	#ifdef __U_STATISTICS__
+	unsigned long long int allocHits, allocRefills;	// allocations from magazine / refills of empty magazine
+	unsigned long long int freeHits, freeFlushes;	// frees to magazine / flushes of full magazine
+	#endif // __U_STATISTICS__
+    }; // uHeapCache
 } // UPP
 
 
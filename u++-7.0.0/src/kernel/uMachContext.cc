@@ -375,9 +375,8 @@ namespace UPP {
 	|    task stack   | } size (multiple of 16)
 	|                 | |
 	`-----------------' / <--- limit (16 byte align)
-	0/8                   <--- storage
-	,-----------------.
-	|   guard page    |   debug only
+	,-----------------.   <--- storage (user stack: 0/8 below limit)
+	|   guard page    |   pool stacks only
 	| write protected |
 	`-----------------'   <--- 4/8/16K alignment
     **************************************************************/
@@ -388,24 +387,8 @@ namespace UPP {
 	if ( storage == nullptr ) {
 	    userStack = false;
 	    size = uCeiling( storageSize, 16 );
-	    // use malloc/memalign because "new" raises an exception for out-of-memory
-#ifdef __U_DEBUG__
-	    storage = memalign( pageSize, cxtSize + size + pageSize );
-	    if ( ::mprotect( storage, pageSize, PROT_NONE ) == -1 ) {
-		abort( "(uMachContext &)%p.createContext() : internal error, mprotect failure, error(%d) %s.", this, errno, strerror( errno ) );
-	    } // if
-#else
-	    // assume malloc has 8 byte alignment so add 8 to allow rounding up to 16 byte alignment
-	    storage = malloc( cxtSize + size + 8 );
-#endif // __U_DEBUG__
-	    if ( storage == nullptr ) {
-		abort( "Attempt to allocate %zd bytes of storage for coroutine or task execution-state but insufficient memory available.", size );
-	    } // if
-#ifdef __U_DEBUG__
-	    limit = (char *)storage + pageSize;
-#else
-	    limit = (char *)uCeiling( (unsigned long)storage, 16 ); // minimum alignment
-#endif // __U_DEBUG__
+	    storage = uStackPool::get( uCeiling( pageSize + size + cxtSize, pageSize ), pageSize );
+	    limit = (char *)storage + pageSize;		// above guard page
 	} else {
 #ifdef __U_DEBUG__
 	    if ( ((size_t)storage & (uAlign() - 1)) != 0 ) { // multiple of uAlign ?
@@ -434,6 +417,111 @@ namespace UPP {
     } // uMachContext::createContext
 
 
+    //######################### uStackPool #########################
+
+
+    uStackPool::uStackPool() {
+	for ( unsigned int i = 0; i < Sizes; i += 1 ) {
+	    buckets[i].len = 0;
+	    buckets[i].stacks = nullptr;
+	    buckets[i].cnt = 0;
+	} // for
+	closed = false;
+    } // uStackPool::uStackPool
+
+
+    uStackPool::~uStackPool() {
+	closed = true;					// stacks freed after this point are unmapped
+	for ( unsigned int i = 0; i < Sizes; i += 1 ) {
+	    while ( buckets[i].stacks != nullptr ) {
+		void *storage = buckets[i].stacks;
+		buckets[i].stacks = link( storage, buckets[i].len );
+		::munmap( storage, buckets[i].len );
+	    } // while
+	    buckets[i].cnt = 0;
+	} // for
+    } // uStackPool::~uStackPool
+
+
+    void *uStackPool::pop( size_t len ) {
+	for ( unsigned int i = 0; i < Sizes; i += 1 ) {
+	    Bucket &b = buckets[i];
+	    if ( b.len == len ) {
+	      if ( b.stacks == nullptr ) return nullptr;
+		void *storage = b.stacks;
+		b.stacks = link( storage, len );
+		b.cnt -= 1;
+		return storage;
+	    } // if
+	} // for
+	return nullptr;
+    } // uStackPool::pop
+
+
+    bool uStackPool::push( void *storage, size_t len ) {
+      if ( closed ) return false;
+	Bucket *unused = nullptr;
+	for ( unsigned int i = 0; i < Sizes; i += 1 ) {
+	    Bucket &b = buckets[i];
+	    if ( b.len == len ) {
+	      if ( b.cnt >= MaxCached ) return false;
+		if ( b.cnt >= HighWater ) {		// enough committed stacks cached ?
+		    ::madvise( storage, len, MADV_DONTNEED ); // return pages, keep mapping
+		} // if
+		link( storage, len ) = b.stacks;
+		b.stacks = storage;
+		b.cnt += 1;
+		return true;
+	    } // if
+	    if ( unused == nullptr && b.stacks == nullptr ) unused = &b; // empty bucket can change size
+	} // for
+      if ( unused == nullptr ) return false;		// too many stack sizes
+	unused->len = len;
+	link( storage, len ) = nullptr;
+	unused->stacks = storage;
+	unused->cnt = 1;
+	return true;
+    } // uStackPool::push
+
+
+    void *uStackPool::get( size_t len, size_t guard ) {
+	// Interrupts are disabled so the task cannot migrate to another processor while using the processor's pool.
+	THREAD_GETMEM( This )->disableInterrupts();
+	void *storage = THREAD_GETMEM( activeProcessor )->stackPool.pop( len );
+	THREAD_GETMEM( This )->enableInterrupts();
+      if ( storage != nullptr ) return storage;		// recycled stack, guard page already set
+
+	int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+	flags |= MAP_NORESERVE;				// commit pages on first touch
+#endif // MAP_NORESERVE
+#if defined( MAP_STACK ) && defined( __linux__ )
+	flags |= MAP_STACK;
+#endif // MAP_STACK && __linux__
+	storage = ::mmap( nullptr, len, PROT_READ | PROT_WRITE, flags, -1, 0 );
+	if ( storage == MAP_FAILED ) {
+	    abort( "Attempt to allocate %zd bytes of storage for coroutine or task execution-state but insufficient memory available.", len );
+	} // if
+	if ( ::mprotect( storage, guard, PROT_NONE ) == -1 ) {
+	    abort( "(uStackPool &).get() : internal error, mprotect failure, error(%d) %s.", errno, strerror( errno ) );
+	} // if
+	return storage;
+    } // uStackPool::get
+
+
+    void uStackPool::put( void *storage, size_t len ) {
+	THREAD_GETMEM( This )->disableInterrupts();
+	bool cached = THREAD_GETMEM( activeProcessor )->stackPool.push( storage, len );
+	THREAD_GETMEM( This )->enableInterrupts();
+	if ( ! cached ) {
+	    ::munmap( storage, len );
+	} // if
+    } // uStackPool::put
+
+
+    //######################### uMachContext (cont) #########################
+
+
     void *uMachContext::stackPointer() const {
 	if ( &uThisCoroutine() == this ) {		// accessing myself ?
 	    void *sp;					// use my current stack value
@@ -36,9 +36,11 @@
 #include <uProcessor.h>
 
 #include <uDebug.h>					// access: uDebugWrite
+#include <uHeapLmmm.h>					// access: uHeapManager::sampleStart
 #undef __U_DEBUG_H__					// turn off debug prints
 
 #include <cstring>					// strerror
+#include <cstddef>					// offsetof
 #include <cerrno>
 #include <unistd.h>					// getpid
 
@@ -146,6 +148,7 @@ void uProcessorTask::main() {
 	    THREAD_SETMEM( activeCluster, cluster );
 	    cluster->processorAdd( processor );
 	    currCluster = cluster;			// change task's notion of which cluster it is executing on
+	    if ( prevCluster.numaNode != cluster->numaNode ) uCluster::numaPolicy( cluster->numaNode ); // adopt memory policy of new cluster
 
 #if __U_LOCALDEBUGGER_H__
 	    if ( uLocalDebugger::uLocalDebuggerActive ) uLocalDebugger::uLocalDebuggerInstance->migrateKernelThread( processor, *cluster );
@@ -232,6 +235,8 @@ void * uKernelModule::startThread( void * p __attribute__(( unused )) ) {
     THREAD_SETMEM( activeProcessor, &processor );
     uCluster *currCluster = THREAD_GETMEM( activeProcessor )->currCluster;
     THREAD_SETMEM( activeCluster, currCluster );
+    if ( currCluster->numaNode >= 0 ) uCluster::numaPolicy( currCluster->numaNode ); // heap pages touched by this processor from cluster's node
+    UPP::uHeapManager::sampleStart();			// first heap-profile sample interval for this kernel thread
     
     assert( THREAD_GETMEM( disableInt ) && THREAD_GETMEM( disableIntCnt ) == 1 );
 
@@ -277,6 +282,18 @@ void uProcessorKernel::scheduleInternal( uBaseSpinLock *lock ) {
 } // uProcessorKernel::scheduleInternal
 
 
+void uProcessorKernel::scheduleInternal( uMCSLock *lock ) {
+    assert( ! uThisTask().readyRef.listed() );
+    assert( THREAD_GETMEM( disableIntSpinCnt ) == 1 );
+
+    taskIsBlocking();
+
+    kind = 4;
+    prevMCSLock = lock;
+    taskCxtSw();					// not resume because entering kernel
+} // uProcessorKernel::scheduleInternal
+
+
 void uProcessorKernel::scheduleInternal( uBaseTask *task ) {
     // SKULLDUGGERY: uBootTask is on ready queue for first entry into the kernel.
     assert( &uThisTask() != (uBaseTask *)uKernelModule::bootTask ? ! uThisTask().readyRef.listed() : true );
@@ -305,6 +322,17 @@ void uProcessorKernel::scheduleInternal( uBaseSpinLock *lock, uBaseTask *task )
 } // uProcessorKernel::scheduleInternal
 
 
+void uProcessorKernel::scheduleInternal( uCluster *cluster ) {
+    assert( ! uThisTask().readyRef.listed() );
+    assert( ! THREAD_GETMEM( disableIntSpin ) );
+
+    kind = 5;
+    nextTask = &uThisTask();
+    nextCluster = cluster;
+    taskCxtSw();					// not resume because entering kernel
+} // uProcessorKernel::scheduleInternal
+
+
 #define SCHEDULE_BODY(parm...) \
     THREAD_GETMEM( This )->disableInterrupts(); \
     activeProcessorKernel->scheduleInternal( parm ); \
@@ -332,6 +360,12 @@ void uProcessorKernel::schedule( uBaseSpinLock *lock ) {
 } // uProcessorKernel::schedule
 
 
+void uProcessorKernel::schedule( uMCSLock *lock ) {
+    SCHEDULE_BODY( lock );
+    SCHEDULE_PROFILE()
+} // uProcessorKernel::schedule
+
+
 void uProcessorKernel::schedule( uBaseTask *task ) {
     SCHEDULE_BODY( task );
     SCHEDULE_PROFILE()
@@ -344,6 +378,12 @@ void uProcessorKernel::schedule( uBaseSpinLock *lock, uBaseTask *task ) {
 } // uProcessorKernel::schedule
 
 
+void uProcessorKernel::schedule( uCluster *cluster ) {
+    SCHEDULE_BODY( cluster );
+    SCHEDULE_PROFILE()
+} // uProcessorKernel::schedule
+
+
 void uProcessorKernel::onBehalfOfUser() {
     switch( kind ) {
       case 0:
@@ -358,6 +398,12 @@ void uProcessorKernel::onBehalfOfUser() {
 	prevLock->release();
 	nextTask->wake();
 	break;
+      case 4:
+	prevMCSLock->release();
+	break;
+      case 5:
+	nextCluster->inboxAdd( *nextTask );		// task is off its stack, so a processor of the cluster may run it
+	break;
       default:
 	abort( "(uProcessorKernel &)%p.onBehalfOfUser : internal error, schedule kind:%d.", this, kind );
 	break;
@@ -769,6 +815,9 @@ void uProcessorKernel::main() {
     // If available, wake another processor on this cluster, as this one is terminating.
     uThisCluster().makeProcessorActive();
 
+    // Return the heap blocks cached by this kernel thread to the global free lists.
+    uHeapControl::finishThread();
+
 //#if defined( __U_MULTI__ )
 //    // Cannot call RealRtn::pthread_exit( nullptr ) because it performs a handler cleanup that raises an exception on
 //    // Linux. The exception attempt to acquire a pthread_mutex_lock that calls a uOwnerLock, which cannot be called from
@@ -791,7 +840,16 @@ uProcessorKernel::~uProcessorKernel() {
 //######################### uProcessor #########################
 
 
+static_assert( alignof(uProcessor) == uCacheLine(), "uProcessor is not cache-line aligned" );
+
+
 void uProcessor::createProcessor( uCluster &cluster, bool detached, int ms, int spin ) {
+    // The fields of uProcessor modified by other processors start a cache line and must fit in it (see uC++.h).
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+    static_assert( offsetof(uProcessor, processorRef) - offsetof(uProcessor, external) == uCacheLine(), "uProcessor remotely modified fields exceed a cache line" );
+#pragma GCC diagnostic pop
+
     uDEBUGPRT( uDebugPrt( "(uProcessor &)%p.createProcessor, on cluster %.256s (%p)\n", this, cluster.getName(), &cluster ); )
 
 #ifdef __U_DEBUG__
@@ -51,6 +51,27 @@ namespace UPP {
 //######################### uSemaphore #########################
 
 
+    // While no task is waiting, the counter is non-negative and P and V complete with one atomic instruction without
+    // acquiring spinLock. A task blocks only after making the counter negative while holding spinLock, so while it is
+    // negative, only the holder of spinLock changes it, and the counter and the waiting queue stay consistent.
+
+    static inline bool decrement( volatile int &count ) { // counter positive ? then decrement
+	int c = __atomic_load_n( &count, __ATOMIC_RELAXED );
+	while ( c > 0 ) {
+	    if ( uCompareAssignValue( count, c, c - 1 ) ) return true;
+	} // while
+	return false;
+    } // decrement
+
+    static inline bool advance( volatile int &count, int inc ) { // no waiting tasks ? then increment
+	int c = __atomic_load_n( &count, __ATOMIC_RELAXED );
+	while ( c >= 0 ) {
+	    if ( uCompareAssignValue( count, c, c + inc ) ) return true;
+	} // while
+	return false;
+    } // advance
+
+
     void uSemaphore::waitTimeout( TimedWaitHandler &h ) {
 	// This uSemaphore member is called from the kernel, and therefore, cannot block, but it can spin.
 
@@ -60,7 +81,7 @@ namespace UPP {
 	    // Remove is a linear search on a queue, but timeouts should be rare and the waiting queue should be short.
 	    waiting.remove( &(task.entryRef) );		// remove this task, O(N)
 	    h.timedout = true;
-	    count += 1;					// adjust the count to reflect the wake up
+	    uFetchAdd( count, 1 );			// adjust the count to reflect the wake up
 	    spinLock.release();
 	    task.wake();				// wake up task
 	} else {
@@ -70,9 +91,9 @@ namespace UPP {
 
 
     void uSemaphore::P() {				// wait on a semaphore
+      if ( decrement( count ) ) return;			// fast path
 	spinLock.acquire();
-	count -= 1;
-	if ( count < 0 ) {
+	if ( uFetchAdd( count, -1 ) <= 0 ) {		// counter decremented below zero ?
 	    waiting.addTail( &(uThisTask().entryRef) );	// queue current task
 #ifdef __U_STATISTICS__
 	    uFetchAdd( UPP::Statistics::io_lock_queue, 1 );
@@ -90,9 +111,9 @@ namespace UPP {
 
 
     bool uSemaphore::P( uTime time ) {			// wait on a semaphore
+      if ( decrement( count ) ) return true;		// fast path
 	spinLock.acquire();
-	count -= 1;
-	if ( count < 0 ) {
+	if ( uFetchAdd( count, -1 ) <= 0 ) {		// counter decremented below zero ?
 	    uBaseTask &task = uThisTask();		// optimization
 	    TimedWaitHandler handler( task, *this );	// handler to wake up blocking task
 	    uEventNode timeoutEvent( task, handler, time, 0 );
@@ -113,16 +134,14 @@ namespace UPP {
     void uSemaphore::P( uSemaphore &s ) {		// wait on a semaphore and release another
 	spinLock.acquire();
 	if ( &s == this ) {				// perform operation on self ?
-	    if ( count < 0 ) {				// V my semaphore
+	    if ( uFetchAdd( count, 1 ) < 0 ) {		// V my semaphore
 		waiting.dropHead()->task().wake();	// remove task at head of waiting list
 	    } // if
-	    count += 1;
 	} else {
 	    s.V();					// V other semaphore
 	} // if
 
-	count -= 1;					// now P my semaphore
-	if ( count < 0 ) {
+	if ( uFetchAdd( count, -1 ) <= 0 ) {		// now P my semaphore
 	    waiting.addTail( &(uThisTask().entryRef) );	// block current task
 	    uProcessorKernel::schedule( &spinLock );	// atomically release spin lock and block
 	} else {
@@ -139,16 +158,14 @@ namespace UPP {
     bool uSemaphore::P( uSemaphore &s, uTime time ) {	// wait on semaphore and release another
 	spinLock.acquire();
 	if ( &s == this ) {				// perform operation on self ?
-	    if ( count < 0 ) {				// V my semaphore
+	    if ( uFetchAdd( count, 1 ) < 0 ) {		// V my semaphore
 		waiting.dropHead()->task().wake();	// remove task at head of waiting list
 	    } // if
-	    count += 1;
 	} else {
 	    s.V();					// V other semaphore
 	} // if
 
-	count -= 1;					// now P my semaphore
-	if ( count < 0 ) {
+	if ( uFetchAdd( count, -1 ) <= 0 ) {		// now P my semaphore
 	    uBaseTask &task = uThisTask();		// optimization
 	    TimedWaitHandler handler( task, *this );	// handler to wake up blocking task
 	    uEventNode timeoutEvent( task, handler, time, 0 );
@@ -167,23 +184,16 @@ namespace UPP {
 
 
     bool uSemaphore::TryP() {				// conditionally wait on a semaphore
-	spinLock.acquire();
-	if ( count > 0 ) {
-	    count -= 1;
-	    spinLock.release();
-	    return true;
-	} // if
-	spinLock.release();
-	return false;
+	return decrement( count );
     } // uSemaphore::TryP
 
 
     void uSemaphore::V() {				// signal semaphore
 	// special form to handle the case where the woken task deletes the semaphore storage
 	uBaseTaskDL *task;
+      if ( advance( count, 1 ) ) return;		// fast path, semaphore not accessed after increment
 	spinLock.acquire();
-	count += 1;
-	if ( count <= 0 ) {
+	if ( uFetchAdd( count, 1 ) < 0 ) {		// task waiting ?
 	    task = waiting.dropHead();			// remove task at head of waiting list
 #ifdef __U_STATISTICS__
 	    uFetchAdd( UPP::Statistics::io_lock_queue, -1 );
@@ -202,13 +212,11 @@ namespace UPP {
 	    abort( "Attempt to advance uSemaphore %p to %d that must be >= 0.", this, inc );
 	} // if
 #endif // __U_DEBUG__
+      if ( advance( count, inc ) ) return;		// fast path
 	spinLock.acquire();
 	for ( int i = inc; i > 0; i -= 1 ) {
-	    if ( count >= 0 ) {
-		count += i;
-		break;
-	    } // if
-	    count += 1;
+	    if ( advance( count, i ) ) break;		// no more waiting tasks ?
+	    uFetchAdd( count, 1 );
 	    waiting.dropHead()->task().wake();		// remove task at head of waiting list and make new owner
 	} // for
 	spinLock.release();
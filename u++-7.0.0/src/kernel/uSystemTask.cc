@@ -45,6 +45,9 @@ void uSystemTask::main() {
 	    delete victim;
 	} or _Accept( pthreadDetachEnd ) {
 	    delete victim;
+	} or _Accept( purgeStart ) {
+	} or _When( UPP::uHeapControl::purging() ) _Timeout( UPP::uHeapControl::purgeInterval() ) {
+	    UPP::uHeapControl::purge();			// return unused heap pages to the OS
 // #if __U_LOCALDEBUGGER_H__
 // 	} or _Timeout( uDuration( 1 ) ) {		// 1 second
 // #endif // __U_LOCALDEBUGGER_H__
@@ -78,6 +81,10 @@ void uSystemTask::reaper( uBaseTask &victim ) {
 } // uSystemTask::reaper
 
 
+void uSystemTask::purgeStart() {
+} // uSystemTask::purgeStart
+
+
 // Local Variables: //
 // compile-command: "make install" //
 // End: //
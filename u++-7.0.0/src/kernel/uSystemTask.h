@@ -43,6 +43,7 @@ _Task uSystemTask {
     uSystemTask();
     ~uSystemTask();
     void reaper( uBaseTask &victim );
+    void purgeStart();					// heap purging turned on, start purge timeout
 }; // uSystemTask
 
 
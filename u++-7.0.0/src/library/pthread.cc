@@ -29,7 +29,6 @@
 #define __U_KERNEL__
 #include <uC++.h>
 #include <uSystemTask.h>
-#include <uSequence.h>
 #include <csignal>					// access: sigset_t
 #include <cerrno>					// access: EBUSY, ETIMEDOUT
 #include <cstdlib>					// access: exit
@@ -48,15 +47,24 @@
 #define NOT_A_PTHREAD ((pthread_t)-2)			// used as return from pthread_self for non-pthread tasks
 
 namespace UPP {
-    struct Pthread_values : public uSeqable {		// thread specific data
-	bool in_use;
+    // A key's generation is odd while the key is in use and is incremented by both pthread_key_create and
+    // pthread_key_delete. A task's value for a key is visible only while the generation stored with the value matches
+    // the key's current generation, so deleting a key invalidates every task's value without visiting the tasks, and
+    // get/set only read the shared key table.
+
+    struct Pthread_values {				// thread specific data
+	unsigned long int generation;			// key generation when value set, 0 => never set
 	void *value;
     }; // Pthread_values
 
+    struct Pthread_specific {				// per task, two-level so sparse use of keys stays small
+	enum { BlockKeys = 32, Blocks = ( PTHREAD_KEYS_MAX + BlockKeys - 1 ) / BlockKeys };
+	Pthread_values *blocks[Blocks];			// allocated on first set of a key in the block
+    }; // Pthread_specific
+
     struct Pthread_keys {				// all of these fields are initialized with zero
-	bool in_use;
-	void (*destructor)( void * );
-	uSequence<Pthread_values> threads;
+	volatile unsigned long int generation;		// odd => in use
+	void (* volatile destructor)( void * );
     }; // Pthread_keys
 
     // Create storage separately to ensure no constructors are called.
@@ -781,9 +789,16 @@ extern "C" {
     //######################### Thread Specific Data #########################
 
 
+    static inline bool key_in_use( unsigned long int generation ) {
+	return generation & 1;
+    } // key_in_use
+
+    static inline unsigned long int key_generation( pthread_key_t key ) {
+	return __atomic_load_n( &u_pthread_keys[key].generation, __ATOMIC_ACQUIRE );
+    } // key_generation
+
     void pthread_deletespecific_( void *pthreadData ) __THROW { // see uMachContext::invokeTask
-	pthread_mutex_lock( &u_pthread_keys_lock );
-	Pthread_values *values = (Pthread_values *)pthreadData;
+	Pthread_specific *specific = (Pthread_specific *)pthreadData;
 
 	// If, after all the destructors have been called for all non-null values with associated destructors, there are
 	// still some non-null values with associated destructors, then the process is repeated. If, after at least
@@ -795,44 +810,46 @@ extern "C" {
 	bool destcalled = true;
 	for ( int attempts = 0; attempts < PTHREAD_DESTRUCTOR_ITERATIONS && destcalled ; attempts += 1 ) {
 	    destcalled = false;
-	    for ( int i = 0; i < PTHREAD_KEYS_MAX; i += 1 ) { // remove each value from key list
-		uDEBUGPRT(
-		    if ( values[i].in_use ) {
-			uDebugPrt( "pthread_deletespecific_, value[%d].in_use:%d, value:%p\n",
-				   i, values[i].in_use, values[i].value );
-		    } // if
-		)
-		if ( values[i].in_use ) {
-		    Pthread_values &entry = values[i];
-		    entry.in_use = false;
-		    u_pthread_keys[i].threads.remove( &entry );
-		    if ( u_pthread_keys[i].destructor != nullptr && entry.value != nullptr ) {
+	    for ( int b = 0; b < Pthread_specific::Blocks; b += 1 ) {
+		Pthread_values *values = specific->blocks[b];
+	      if ( values == nullptr ) continue;		// no key in block ever set
+		for ( int k = 0; k < Pthread_specific::BlockKeys; k += 1 ) {
+		    pthread_key_t i = b * Pthread_specific::BlockKeys + k;
+		  if ( i >= PTHREAD_KEYS_MAX ) break;
+		    Pthread_values &entry = values[k];
+		  if ( entry.generation == 0 ) continue;	// never set
+		    unsigned long int generation = key_generation( i );
+		    void (*destructor)( void * ) = u_pthread_keys[i].destructor;
+		    bool current = entry.generation == generation; // key not deleted since value set ?
+		    entry.generation = 0;
+		    uDEBUGPRT( uDebugPrt( "pthread_deletespecific_, value[%d] current:%d, value:%p\n", i, current, entry.value ); )
+		    if ( current && destructor != nullptr && entry.value != nullptr ) {
 			void *data = entry.value;
 			entry.value = nullptr;
 			uDEBUGPRT( uDebugPrt( "pthread_deletespecific_, task:%p, destructor:%p, value:%p begin\n",
-					      &uThisTask(), u_pthread_keys[i].destructor, data ); )
+					      &uThisTask(), destructor, data ); )
 			destcalled = true;
-			pthread_mutex_unlock( &u_pthread_keys_lock );
-			u_pthread_keys[i].destructor( data );
-			pthread_mutex_lock( &u_pthread_keys_lock );
+			destructor( data );			// may set values again
 			uDEBUGPRT( uDebugPrt( "pthread_deletespecific_, task:%p, destructor:%p, value:%p end\n",
-					      &uThisTask(), u_pthread_keys[i].destructor, data ); )
+					      &uThisTask(), destructor, data ); )
 		    } // if
-		} // if
+		} // for
 	    } // for
 	} // for
-	pthread_mutex_unlock( &u_pthread_keys_lock );
-	delete [] values;
+	for ( int b = 0; b < Pthread_specific::Blocks; b += 1 ) {
+	    delete [] specific->blocks[b];
+	} // for
+	delete specific;
     } // pthread_deletespecific_
 
 
     int pthread_key_create( pthread_key_t *key, void (*destructor)( void * ) ) __THROW {
 	uDEBUGPRT( uDebugPrt( "pthread_key_create(key:%p, destructor:%p) enter task:%p\n", key, destructor, &uThisTask() ); )
-	pthread_mutex_lock( &u_pthread_keys_lock );
+	pthread_mutex_lock( &u_pthread_keys_lock );		// serialize create/delete, get/set do not lock
 	for ( int i = 0; i < PTHREAD_KEYS_MAX; i += 1 ) {
- 	    if ( ! u_pthread_keys[i].in_use ) {
-		u_pthread_keys[i].in_use = true;
+ 	    if ( ! key_in_use( u_pthread_keys[i].generation ) ) {
 		u_pthread_keys[i].destructor = destructor;
+		__atomic_store_n( &u_pthread_keys[i].generation, u_pthread_keys[i].generation + 1, __ATOMIC_RELEASE ); // publish destructor
 		pthread_mutex_unlock( &u_pthread_keys_lock );
 		*key = i;
 		uDEBUGPRT( uDebugPrt( "pthread_key_create(key:%d, destructor:%p) exit task:%p\n", *key, destructor, &uThisTask() ); )
@@ -847,22 +864,15 @@ extern "C" {
     int pthread_key_delete( pthread_key_t key ) __THROW {
 	uDEBUGPRT( uDebugPrt( "pthread_key_delete(key:0x%x) enter task:%p\n", key, &uThisTask() ); )
 	pthread_mutex_lock( &u_pthread_keys_lock );
-      if ( key >= PTHREAD_KEYS_MAX || ! u_pthread_keys[key].in_use ) {
+      if ( key >= PTHREAD_KEYS_MAX || ! key_in_use( u_pthread_keys[key].generation ) ) {
 	    pthread_mutex_unlock( &u_pthread_keys_lock );
 	    return EINVAL;
 	} // if
-	u_pthread_keys[key].in_use = false;
-	u_pthread_keys[key].destructor = nullptr;
 
-	// Remove key from all threads with a value.
-
-	Pthread_values *p;
-	uSequence<Pthread_values> &head = u_pthread_keys[key].threads;
-	for ( uSeqIter<Pthread_values> iter( head ); iter >> p; ) {
-	    p->in_use = false;
-	    head.remove( p );
-	} // for
+	// Advancing the generation invalidates the key's value in all threads, which are freed when each thread ends.
 
+	__atomic_store_n( &u_pthread_keys[key].generation, u_pthread_keys[key].generation + 1, __ATOMIC_RELEASE );
+	u_pthread_keys[key].destructor = nullptr;
 	pthread_mutex_unlock( &u_pthread_keys_lock );
 	uDEBUGPRT( uDebugPrt( "pthread_key_delete(key:0x%x) exit task:%p\n", key, &uThisTask() ); )
 	return 0;
@@ -870,32 +880,26 @@ extern "C" {
 
     int pthread_setspecific( pthread_key_t key, const void *value ) __THROW {
 	uDEBUGPRT( uDebugPrt( "pthread_setspecific(key:0x%x, value:%p) enter task:%p\n", key, value, &uThisTask() ); )
-	uBaseTask &t = uThisTask();
+      if ( key >= PTHREAD_KEYS_MAX ) return EINVAL;
+	unsigned long int generation = key_generation( key );
+      if ( ! key_in_use( generation ) ) return EINVAL;
 
-	Pthread_values *values;
-	if ( t.pthreadData == nullptr ) {
-	    values = new Pthread_values[PTHREAD_KEYS_MAX];
-	    t.pthreadData = values;
-	    for ( int i = 0; i < PTHREAD_KEYS_MAX; i += 1 ) {
-		values[i].in_use = false;
-	    } // for
-	} else {
-	    values = (Pthread_values *)t.pthreadData;
-	} // if
+	// Only the owning task accesses its values, so allocation and update need no locking.
 
-	pthread_mutex_lock( &u_pthread_keys_lock );
-      if ( key >= PTHREAD_KEYS_MAX || ! u_pthread_keys[key].in_use ) {
-	    pthread_mutex_unlock( &u_pthread_keys_lock );
-	    return EINVAL;
+	uBaseTask &t = uThisTask();
+	Pthread_specific *specific = (Pthread_specific *)t.pthreadData;
+	if ( specific == nullptr ) {
+	    specific = new Pthread_specific();		// zero filled
+	    t.pthreadData = specific;
 	} // if
-
-	Pthread_values &entry = values[key];
-	if ( ! entry.in_use ) {
-	    entry.in_use = true;
-	    u_pthread_keys[key].threads.add( &entry );
+	Pthread_values *&values = specific->blocks[key / Pthread_specific::BlockKeys];
+	if ( values == nullptr ) {
+	    values = new Pthread_values[Pthread_specific::BlockKeys]();	// zero filled
 	} // if
+
+	Pthread_values &entry = values[key % Pthread_specific::BlockKeys];
+	entry.generation = generation;
 	entry.value = (void *)value;
-	pthread_mutex_unlock( &u_pthread_keys_lock );
 	uDEBUGPRT( uDebugPrt( "pthread_setspecific(key:0x%x, value:%p) exit task:%p\n", key, value, &uThisTask() ); )
 	return 0;
     } // pthread_setspecific
@@ -905,16 +909,14 @@ extern "C" {
       if ( key >= PTHREAD_KEYS_MAX ) return nullptr;
 
 	uBaseTask &t = uThisTask();
-      if ( t.pthreadData == nullptr ) return nullptr;
+	Pthread_specific *specific = (Pthread_specific *)t.pthreadData;
+      if ( specific == nullptr ) return nullptr;
+	Pthread_values *values = specific->blocks[key / Pthread_specific::BlockKeys];
+      if ( values == nullptr ) return nullptr;
 
-	pthread_mutex_lock( &u_pthread_keys_lock );
-	Pthread_values &entry = ((Pthread_values *)t.pthreadData)[key];
-      if ( ! entry.in_use ) {
-	    pthread_mutex_unlock( &u_pthread_keys_lock );
-	    return nullptr;
-	} // if
+	Pthread_values &entry = values[key % Pthread_specific::BlockKeys];
+      if ( entry.generation != key_generation( key ) ) return nullptr; // never set or key deleted since set
 	void *value = entry.value;
-	pthread_mutex_unlock( &u_pthread_keys_lock );
 	uDEBUGPRT( uDebugPrt( "%p = pthread_getspecific(key:0x%x) exit task:%p\n", value, key, &uThisTask() ); )
 	return value;
     } // pthread_getspecific
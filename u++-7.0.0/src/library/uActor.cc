@@ -32,6 +32,7 @@
 uExecutor uActor::executor_( uDefaultActorMailboxes(), uDefaultActorThreads(), uDefaultActorProcessors(), uDefaultActorOffset(), uDefaultActorSepClus() ); // executor for all actors
 uSemaphore uActor::wait_( 0 );				// uMain::main waits for all actors to be destroyed
 unsigned long int uActor::alive_ = 0;			// number of actor objects in system
+unsigned int uActor::batch_ = uDefaultActorBatch();	// maximum messages processed per activation
 uActor::StartMsg uActor::startMsg;			// start actor
 uActor::StopMsg uActor::stopMsg;			// terminate actor
 uActor::UnhandledMsg uActor::unhandledMsg;		// tell error
@@ -44,15 +44,59 @@ class uActor {
     static uExecutor executor_;				// singleton
     static uSemaphore wait_;				// wait for all actors to delete
     static unsigned long int alive_;			// number of actor objects in system
+    static unsigned int batch_;				// maximum messages processed per activation
 
-    unsigned long int ticket_;				// executor-queue handle to provide FIFO message execution
+    struct Letter_ : public uColable {			// actor mailbox entry
+	virtual bool open_( uActor & actor ) = 0;	// true => actor deleted
+	virtual void discard_() = 0;			// actor deleted before letter opened
+    }; // Letter_
+
+    // Each actor owns a mailbox and only the actor is scheduled on the executor. An activation processes up to batch_
+    // messages and then goes to the back of the executor mailbox, so a busy actor cannot starve the others. The actor
+    // is rescheduled on the worker that last ran it, keeping its state in that worker's cache.
+    struct Activation_ : public uExecutor::WRequest {
+	uActor & actor;
+
+	Activation_( uActor & actor ) : actor( actor ) {}
+	void doit( uExecutor::NodePool & pool ) { actor.drain_( pool ); }
+    }; // Activation_
+
+    unsigned long int ticket_;				// executor-queue handle, changed to last worker running actor
+    uSpinLock lock_;					// protects mailbox_ and scheduled_
+    uQueue< Letter_ > mailbox_;
+    bool scheduled_ = false;				// activation in executor or running ?
+    Activation_ activation_;
   public:
     enum Allocation { Nodelete, Delete, Destroy };	// allocation actions
 
     struct Message {
 	Allocation allocation;				// allocation action
 	uActor *sender;					// delegated sender
-
+      private:
+	friend class uActor;
+
+	// Mailbox entry embedded in the message so a send needs no allocation. A message can be queued for several
+	// receivers at once (e.g., stopMsg), so the envelope is claimed and a message already in flight is wrapped in a
+	// separate entry. The envelope is released before the receiver runs, so the receiver can forward the message.
+	struct Envelope_ : public Letter_ {
+	    volatile bool queued = false;		// envelope in a mailbox ?
+	    Message * msg;
+
+	    Envelope_() {}
+	    Envelope_( const Envelope_ & ) : Letter_() {} // copied message is not queued
+	    Envelope_ & operator=( const Envelope_ & ) { return *this; }
+	    bool open_( uActor & actor ) {
+		Message & message = *msg;
+		__atomic_store_n( &queued, false, __ATOMIC_RELEASE ); // message may be resent or deleted by receiver
+		return deliver_( actor, message );
+	    } // Envelope_::open_
+	    void discard_() {
+		Message & message = *msg;
+		__atomic_store_n( &queued, false, __ATOMIC_RELEASE );
+		finalize_( message );
+	    } // Envelope_::discard_
+	} envelope_;
+      public:
 	Message( Allocation allocation = Nodelete, uActor * sender = nullptr ) : allocation( allocation ), sender( sender ) {}
 	Message( uActor * sender ) : allocation( Delete ), sender( sender ) {}
 	virtual ~Message() {}
@@ -81,41 +125,106 @@ class uActor {
 	void reset() { result.reset(); }
     }; // FutureMessage
   private:
-    struct Deliver_ {
-	uActor & actor;
+    static void finalize_( Message & msg ) {		// message allocation action
+	if ( msg.allocation == Delete ) { delete &msg; }
+	else if ( msg.allocation == Destroy ) msg.~Message();
+    } // uActor::finalize_
+
+    static bool deliver_( uActor & actor, Message & msg ) { // true => actor deleted
+	Allocation ret = Nodelete;
+	try {
+	    ret = actor.process_( msg );		// call current message handler
+	    if ( ret == Delete ) { delete &actor; }
+	    else if ( ret == Destroy ) actor.~uActor();
+	} catch ( uBaseEvent &ex ) {
+	    Case( uActor::ReplyMsg, msg ) {		// unknown future message
+		msg_t->delivery( ex.duplicate() );	// complain in future
+	    } else {
+		_Throw;				// fail to worker thread
+	    } // Case
+	} catch ( ... ) {
+	    abort( "C++ exceptions unsupported from throw in actor for future message" );
+	    // Case( uActor::ReplyMsg, msg ) {	// unknown future message
+	    //     //msg_t->reply( std::current_exception() ); // complain in future
+	    // } else {
+	    //     _Throw;
+	    // } // Case
+	} _Finally {
+	    finalize_( msg );
+	} // try
+	return ret != Nodelete;
+    } // uActor::deliver_
+
+    struct Forward_ : public Letter_ {			// message already queued for another receiver
 	Message & msg;
 
-	Deliver_( uActor & actor, Message & msg ) : actor( actor ), msg( msg ) {}
-
-	void operator()() {				// functor
-	    try {
-		Allocation ret = actor.process_( msg );	// call current message handler
-		if ( ret == Delete ) { delete &actor; }
-		else if ( ret == Destroy ) actor.~uActor();
-	    } catch ( uBaseEvent &ex ) {
-		Case( uActor::ReplyMsg, msg ) {		// unknown future message
-		    msg_t->delivery( ex.duplicate() );	// complain in future
-		} else {
-		    _Throw;				// fail to worker thread
-		} // Case
-	    } catch ( ... ) {
-		abort( "C++ exceptions unsupported from throw in actor for future message" );
-		// Case( uActor::ReplyMsg, msg ) {	// unknown future message
-		//     //msg_t->reply( std::current_exception() ); // complain in future
-		// } else {
-		//     _Throw;
-		// } // Case
-	    } _Finally {
-		if ( msg.allocation == Delete ) { delete &msg; }
-		else if ( msg.allocation == Destroy ) msg.~Message();
-	    } // try
-	} // Deliver_::operator()
-    }; // Deliver_
+	Forward_( Message & msg ) : msg( msg ) {}
+	bool open_( uActor & actor ) {
+	    Message & message = msg;
+	    delete this;
+	    return deliver_( actor, message );
+	} // Forward_::open_
+	void discard_() {
+	    finalize_( msg );
+	    delete this;
+	} // Forward_::discard_
+    }; // Forward_
+
+    template< typename Func > struct Call_ : public Letter_ { // internal action, e.g., preStart
+	Func action;
+
+	Call_( Func action ) : action( action ) {}
+	bool open_( uActor & ) {
+	    Func act = action;
+	    delete this;
+	    act();
+	    return false;
+	} // Call_::open_
+	void discard_() { delete this; }
+    }; // Call_
+
+    void post_( Letter_ & letter ) {
+	lock_.acquire();
+	mailbox_.addTail( &letter );
+	bool idle = ! scheduled_;
+	scheduled_ = true;
+	lock_.release();
+	if ( idle ) executor_.insert( &activation_, ticket_ ); // first message => schedule actor
+    } // uActor::post_
+
+    void post_( Message & msg ) {
+	if ( ! uFetchAssign( msg.envelope_.queued, true ) ) { // claim envelope
+	    msg.envelope_.msg = &msg;
+	    post_( msg.envelope_ );
+	} else {
+	    post_( *new Forward_( msg ) );
+	} // if
+    } // uActor::post_
+
+    void drain_( uExecutor::NodePool & pool ) {		// executor activation
+	ticket_ = pool.home;				// affinity with this worker
+	for ( unsigned int n = 0;; n += 1 ) {
+	    lock_.acquire();
+	    if ( mailbox_.empty() ) {
+		scheduled_ = false;
+		lock_.release();
+		return;
+	    } // if
+	    if ( n == batch_ ) {			// fairness bound ?
+		lock_.release();
+		executor_.insert( &activation_, ticket_ ); // back of the line
+		return;
+	    } // if
+	    Letter_ * letter = mailbox_.dropHead();
+	    lock_.release();
+	  if ( letter->open_( *this ) ) return;	// actor deleted => stop draining
+	} // for
+    } // uActor::drain_
 
     virtual Allocation process_( Message & msg ) = 0;	// type-safe access to subclass receivePtr
   protected:
     virtual Allocation receive( Message & msg ) = 0;	// user supplied message handler
-    template< typename Func > void send_( Func action ) { uActor::executor_.send( action, ticket_ ); }
+    template< typename Func > void send_( Func action ) { post_( *new Call_< Func >( action ) ); }
     virtual void preStart() { /* default empty */ };	// user supplied actor initialization
 
     struct uActorConstructor {				// translator creates instance in actor constructor
@@ -126,12 +235,21 @@ class uActor {
 	} // uActorConstructor::uActorConstructor
     }; // uActorConstructor
   public:
-    uActor() {
+    uActor() : activation_( *this ) {
 	uFetchAdd( alive_, 1 );				// number of actors in system
 	ticket_ = executor_.tickets();			// get executor queue handle
     } // uActor::uActor
 
     virtual ~uActor() {					// check for last actor
+	// Letters still in the mailbox are never delivered, so release them as a delivery would: the message allocation
+	// action is performed and a shared envelope is marked not queued so the message can be sent again.
+	for ( ;; ) {
+	    lock_.acquire();
+	    Letter_ * letter = mailbox_.dropHead();
+	    lock_.release();
+	  if ( letter == nullptr ) break;
+	    letter->discard_();
+	} // for
 	if ( uFetchAdd( alive_, -1 ) == 1 ) wait_.V();	// 1 => count is zero
     } // uActor::~uActor
 
@@ -139,7 +257,7 @@ class uActor {
 
     uActor & tell( Message & msg, uActor * sender = nullptr ) { // async call, no return
 	msg.sender = sender;
-	executor_.send( Deliver_( *this, msg ), ticket_ ); // copy functor
+	post_( msg );
 	return *this;
     } // uActor::tell
 
@@ -149,7 +267,7 @@ class uActor {
 
     template< typename Result > Future_ISM< Result > ask( FutureMessage< Result > & msg, uActor * sender = nullptr ) { // async call, return future
 	msg.sender = sender;
-	executor_.send( Deliver_( *this, msg ), ticket_ );
+	post_( msg );
 	return msg.result;
     } // uActor::ask
 
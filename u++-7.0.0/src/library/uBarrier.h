@@ -80,16 +80,123 @@ _Mutex _Coroutine uBarrier {
 	    Waiters.wait();
 	} else {
 	    last();					// call the last routine
-	    for ( ; ! Waiters.empty(); ) {		// restart all waiting tasks
-		Waiters.signal();			// LIFO release, N-1 cxt switches
-//		Waiters.signalBlock();			// FIFO release, 2N cxt switches
-	    } // for
+	    Count = 0;					// restarted tasks leave without the count
+	    Waiters.signalAll();			// restart all waiting tasks together
 	} // if
-	Count -= 1;
     } // uBarrier::block
 }; // uBarrier
 
 
+// uTreeBarrier is a combining-tree barrier for large numbers of participants, each passing a distinct identifier less
+// than the total. A participant arrives at a leaf shared with at most Fanin - 1 others, and the last to arrive at a node
+// continues to its parent, so arrivals are spread over many cache lines rather than serialized through one monitor.
+// Other arrivals spin briefly and then block on the node. The last task at the root calls last(), and each released
+// task releases the nodes it was last at, so the wake-ups fan out down the tree with one ready-queue insertion per node.
+
+class uTreeBarrier {
+    enum { Fanin = 4,					// arrivals at each node
+	   Spins = 128 };				// spin before blocking on a node
+
+    struct Node {
+	volatile unsigned int arrived;			// arrivals in the current episode
+	volatile unsigned int episode;			// incremented to release the node
+	unsigned int expected;				// arrivals to release the node
+	Node *parent;					// nullptr => root
+	uSpinLock lock;					// protects waiting
+	uBaseTaskSeq waiting;				// tasks blocked on the node
+
+	Node( unsigned int expected, Node *parent ) : arrived( 0 ), episode( 0 ), expected( expected ), parent( parent ) {}
+    } __attribute__(( aligned (uCacheLine()) ));	// one node per cache line
+
+    unsigned int Total, nodes;
+    Node *tree;						// leaves first, root last
+
+    void wait( Node &node, unsigned int episode ) {
+	for ( unsigned int spin = 0; spin < Spins; spin += 1 ) {
+	  if ( __atomic_load_n( &node.episode, __ATOMIC_ACQUIRE ) != episode ) return;
+	    uPause();
+	} // for
+	node.lock.acquire();
+	if ( node.episode != episode ) {		// released while spinning ?
+	    node.lock.release();
+	    return;
+	} // if
+	node.waiting.addTail( &(uThisTask().entryRef) ); // block current task
+	UPP::uProcessorKernel::schedule( &node.lock );	// atomically release spin lock and block
+    } // uTreeBarrier::wait
+
+    void release( Node &node ) {
+	node.arrived = 0;				// reset before any participant of the node continues
+	uBaseTaskSeq restart;
+	node.lock.acquire();
+	__atomic_store_n( &node.episode, node.episode + 1, __ATOMIC_RELEASE );
+	restart.transfer( node.waiting );
+	node.lock.release();
+	uBaseTask::wake( restart );
+    } // uTreeBarrier::release
+
+    void arrive( Node &node ) {
+	unsigned int episode = __atomic_load_n( &node.episode, __ATOMIC_ACQUIRE ); // node cannot be released before this arrival
+	if ( uFetchAdd( node.arrived, 1 ) + 1 < node.expected ) { // not last arrival ?
+	    wait( node, episode );
+	    return;
+	} // if
+	if ( node.parent != nullptr ) {
+	    arrive( *node.parent );
+	} else {
+	    last();					// call the last routine
+	} // if
+	release( node );
+    } // uTreeBarrier::arrive
+  protected:
+    virtual void last() {				// called by last task to reach the barrier
+    } // uTreeBarrier::last
+  public:
+    uTreeBarrier( const uTreeBarrier & ) = delete;	// no copy
+    uTreeBarrier( uTreeBarrier && ) = delete;
+    uTreeBarrier &operator=( const uTreeBarrier & ) = delete; // no assignment
+
+    uTreeBarrier( unsigned int total ) : Total( total ), nodes( 0 ) {
+	if ( total == 0 ) {
+	    abort( "(uTreeBarrier &)%p.uTreeBarrier( %u ) : Barrier total must be greater than zero.", this, total );
+	} // if
+	for ( unsigned int width = total; width > 1 || nodes == 0; ) { // nodes in all levels
+	    width = ( width + Fanin - 1 ) / Fanin;
+	    nodes += width;
+	} // for
+	tree = (Node *)::memalign( uCacheLine(), nodes * sizeof(Node) );
+	for ( unsigned int base = 0, below = total;; ) { // build level by level
+	    unsigned int width = ( below + Fanin - 1 ) / Fanin;
+	    for ( unsigned int i = 0; i < width; i += 1 ) {
+		unsigned int expected = below - i * Fanin < Fanin ? below - i * Fanin : Fanin;
+		new( &tree[base + i] ) Node( expected, width == 1 ? nullptr : &tree[base + width + i / Fanin] );
+	    } // for
+	  if ( width == 1 ) break;
+	    base += width;
+	    below = width;
+	} // for
+    } // uTreeBarrier::uTreeBarrier
+
+    virtual ~uTreeBarrier() {
+	for ( unsigned int i = 0; i < nodes; i += 1 ) tree[i].~Node();
+	::free( tree );
+    } // uTreeBarrier::~uTreeBarrier
+
+    unsigned int total() const {			// total participants in the barrier
+	return Total;
+    } // uTreeBarrier::total
+
+    void block( unsigned int id ) {			// id < total, distinct among participants
+#ifdef __U_DEBUG__
+	if ( id >= Total ) {
+	    abort( "(uTreeBarrier &)%p.block( %u ) : Participant identifier must be less than barrier total %u.", this, id, Total );
+	} // if
+#endif // __U_DEBUG__
+	arrive( tree[id / Fanin] );
+    } // uTreeBarrier::block
+}; // uTreeBarrier
+
+
 #pragma __U_USER_CODE__
 
 #endif // __U_BARRIER_H__
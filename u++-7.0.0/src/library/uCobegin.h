@@ -43,7 +43,7 @@
 #define BEGIN [&]( unsigned int uLid __attribute__(( unused )) ) {
 #define END } ,
 
-void uCobegin( std::initializer_list< std::function< void( unsigned int ) >> funcs ) {
+inline void uCobegin( std::initializer_list< std::function< void( unsigned int ) >> funcs ) {
     unsigned int uLid = 0;
     _Task Runner {
 	typedef std::function<void( unsigned int )> Func; // function type
@@ -65,28 +65,127 @@ void uCobegin( std::initializer_list< std::function< void( unsigned int ) >> fun
 
 // COFOR
 
+// The iteration range is split evenly among one worker per processor on the cluster, one of which is the calling task.
+// A worker runs chunks from the front of its range, and a worker whose range is empty steals the back half of another
+// worker's range, so the loop body is called for each iteration rather than run by a task per iteration. As iterations
+// may run one after another in the same worker, an iteration must not wait for another iteration.
+
 #define COFOR( lidname, low, high, body ) uCofor( low, high, [&]( unsigned int lidname ){ body } );
 
-template<typename Low, typename High>			// allow bounds to have different types (needed for constants)
-void uCofor( Low low, High high, std::function<void ( unsigned int )> f ) {
-    unsigned int lid = 0;
+namespace UPP {
+    class uCoforRanges {
+	enum { Chunks = 8 };				// chunks per worker range, smaller chunks balance better
+
+	struct Range {
+	    volatile unsigned long long int bounds;	// low in upper half, high in lower half, changed atomically
+	} __attribute__(( aligned (uCacheLine()) ));	// one range per cache line
+
+	Range *ranges;
+	unsigned int workers, chunk;
+
+	static unsigned long long int pack( unsigned int low, unsigned int high ) {
+	    return (unsigned long long int)low << 32 | high;
+	} // uCoforRanges::pack
+
+	bool steal( unsigned int id ) {			// move back half of another range to empty range of worker id
+	    for ( unsigned int v = 1; v < workers; v += 1 ) {
+		Range &victim = ranges[( id + v ) % workers];
+		for ( ;; ) {
+		    unsigned long long int bounds = __atomic_load_n( &victim.bounds, __ATOMIC_RELAXED );
+		    unsigned int low = bounds >> 32, high = bounds;
+		  if ( low >= high ) break;		// nothing to steal
+		    unsigned int mid = low + ( high - low ) / 2;
+		    if ( uCompareAssign( victim.bounds, bounds, pack( low, mid ) ) ) {
+			__atomic_store_n( &ranges[id].bounds, pack( mid, high ), __ATOMIC_RELEASE );
+			return true;
+		    } // if
+		} // for
+	    } // for
+	    return false;				// remaining iterations are claimed
+	} // uCoforRanges::steal
+      public:
+	uCoforRanges( const uCoforRanges & ) = delete;	// no copy
+	uCoforRanges( uCoforRanges && ) = delete;
+	uCoforRanges &operator=( const uCoforRanges & ) = delete; // no assignment
+
+	uCoforRanges( unsigned int size, unsigned int workers, unsigned int chunk = 0 ) : // 0 => default chunk
+		workers( workers ), chunk( chunk != 0 ? chunk : ( size + workers * Chunks - 1 ) / ( workers * Chunks ) ) {
+	    ranges = (Range *)::memalign( uCacheLine(), workers * sizeof(Range) );
+	    for ( unsigned int id = 0; id < workers; id += 1 ) {
+		unsigned long long int total = size;	// no overflow
+		ranges[id].bounds = pack( total * id / workers, total * ( id + 1 ) / workers );
+	    } // for
+	} // uCoforRanges::uCoforRanges
+
+	~uCoforRanges() {
+	    ::free( ranges );
+	} // uCoforRanges::~uCoforRanges
+
+	bool next( unsigned int id, unsigned int &low, unsigned int &high ) { // claim iterations [low, high) for worker id
+	    Range &own = ranges[id];
+	    for ( ;; ) {
+		unsigned long long int bounds = __atomic_load_n( &own.bounds, __ATOMIC_ACQUIRE );
+		low = bounds >> 32;
+		high = bounds;
+		if ( low < high ) {			// own iterations ?
+		    unsigned int end = high - low > chunk ? low + chunk : high;
+		    if ( uCompareAssign( own.bounds, bounds, pack( end, high ) ) ) { // thief may shrink range
+			high = end;
+			return true;
+		    } // if
+		} else if ( ! steal( id ) ) {
+		    return false;
+		} // if
+	    } // for
+	} // uCoforRanges::next
+    }; // uCoforRanges
+} // UPP
+
+template<typename Low, typename High, typename Func>	// allow bounds to have different types (needed for constants)
+void uCofor( Low low, High high, Func f ) {
+    assert( 0 <= high - low );
+    const unsigned int size = high - low;
+  if ( size == 0 ) return;
+    unsigned int workers = uThisCluster().getProcessors();
+    if ( workers > size ) workers = size;		// no idle workers
+    if ( workers == 0 ) workers = 1;
+
+    UPP::uCoforRanges ranges( size, workers );
+    auto work = [&]( unsigned int id ) {
+	for ( unsigned int first, last; ranges.next( id, first, last ); ) {
+	    for ( ; first < last; first += 1 ) f( first + low );
+	} // for
+    };
+    typedef decltype(work) Work;
+
     _Task Runner {
-	typedef std::function<void( unsigned int )> Func; // function type
-	unsigned int parm;				// local thread lid
-	Func f;						// function to run for each lid
+	Work &work;					// worker loop
+	unsigned int id;				// worker range
 
-	void main() { f( parm ); }
+	void main() { work( id ); }
       public:
-	Runner( unsigned int parm, Func f ) : parm( parm ), f( f ) {}
+	Runner( Work &work, unsigned int id ) : work( work ), id( id ) {}
     }; // Runner
 
-    assert( 0 <= high - low );
-    const decltype(lid) size = high - low;
-    Runner **runners = new Runner *[size];		// do not use up task stack
-
-    for ( unsigned int lid = 0; lid < size; lid += 1 ) runners[lid] = new Runner( lid + low, f );
-    for ( unsigned int lid = 0; lid < size; lid += 1 ) delete runners[lid];
-    delete [] runners;
+    struct Join {					// wait for workers even if the body raises an exception
+	Runner **runners;
+	unsigned int size;
+	void wait() {					// deleting a runner can raise an exception from the runner
+	    for ( unsigned int id = 1; id < size; id += 1 ) {
+		Runner *runner = runners[id];
+		runners[id] = nullptr;			// not deleted again if the deletion raises
+		delete runner;
+	    } // for
+	} // Join::wait
+	~Join() noexcept(false) {			// waits for runners not yet deleted, e.g., body raised an exception
+	    wait();
+	    delete [] runners;
+	} // Join::~Join
+    } join = { new Runner *[workers](), workers };	// do not use up task stack
+
+    for ( unsigned int id = 1; id < workers; id += 1 ) join.runners[id] = new Runner( work, id );
+    work( 0 );						// calling task is worker 0
+    join.wait();					// outside the destructor, so a runner exception propagates normally
 } // uCofor
 
 // START/WAIT
@@ -0,0 +1,161 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 7.0.0, Copyright (C) Peter A. Buhr 2018
+//
+// uCombining.h -- Flat-combining execution of operations on a shared object.
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+
+#ifndef __U_COMBINING_H__
+#define __U_COMBINING_H__
+
+#pragma __U_NOT_USER_CODE__
+
+#include <new>						// placement new
+#include <utility>					// forward, move
+
+
+// uCombining<T> runs operations on a shared object of type T one at a time, like the mutex members of a _Monitor, but
+// without passing the object from task to task. A caller publishes its operation on a list and, if no other caller is
+// combining, becomes the combiner: it removes the published operations and runs them in arrival order on behalf of
+// their callers, whose data stays in the combiner's cache, and repeats for operations published meanwhile before
+// giving up the role. A caller whose operation is run by another combiner waits without a context switch per
+// operation. An operation must not block, because it may run in another task; an _Event it raises is raised at its
+// caller, and a C++ exception is unsupported.
+//
+//   uCombining< Counter > counter;
+//   counter( []( Counter &c ) { c.inc(); } );
+//   long int value = counter( []( Counter &c ) { return c.get(); } );
+
+template< typename T > class uCombining {
+    enum { Passes = 4,					// combiner drains the published list at most this often
+	   Spins = 64 };				// waiter spins before yielding
+
+    struct Request {					// published operation, on the caller's stack
+	Request *next;
+	volatile bool done = false;			// set by the combiner after running the operation
+	uBaseEvent *cause = nullptr;			// raised by the operation
+	virtual void apply( T &object ) = 0;
+    }; // Request
+
+    template< typename Func, typename R > struct Call : public Request {
+	Func &action;
+	alignas(R) unsigned char value[sizeof(R)];	// result, constructed by the combiner
+
+	Call( Func &action ) : action( action ) {}
+	void apply( T &object ) { new( value ) R( action( object ) ); }
+
+	R result() {
+	    R *r = (R *)value;
+	    R ret( std::move( *r ) );
+	    r->~R();
+	    return ret;
+	} // Call::result
+    }; // Call
+
+    template< typename Func > struct Call< Func, void > : public Request {
+	Func &action;
+
+	Call( Func &action ) : action( action ) {}
+	void apply( T &object ) { action( object ); }
+	void result() {}
+    }; // Call
+
+    T object;
+    Request * volatile published __attribute__(( aligned (uCacheLine()) )) = nullptr; // operations waiting to run
+    volatile bool combining __attribute__(( aligned (uCacheLine()) )) = false; // a caller is combining
+    unsigned long int batches_ = 0, combined_ = 0;	// written by combiner only
+
+    void publish( Request &request ) {
+	Request *head = __atomic_load_n( &published, __ATOMIC_RELAXED );
+	do {
+	    request.next = head;
+	} while ( ! __atomic_compare_exchange_n( &published, &head, &request, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED ) );
+    } // uCombining::publish
+
+    void combine() {					// combining lock held
+	for ( unsigned int pass = 0; pass < Passes; pass += 1 ) {
+	    Request *list = uFetchAssign( published, (Request *)nullptr );
+	  if ( list == nullptr ) break;
+	    Request *fifo = nullptr;			// published list is LIFO, run in arrival order
+	    while ( list != nullptr ) {
+		Request *next = list->next;
+		list->next = fifo;
+		fifo = list;
+		list = next;
+	    } // while
+	    batches_ += 1;
+	    while ( fifo != nullptr ) {
+		Request *next = fifo->next;		// request disappears once done
+		try {
+		    fifo->apply( object );
+		} catch( uBaseEvent &ex ) {
+		    fifo->cause = ex.duplicate();	// raised at caller
+		} catch( ... ) {
+		    abort( "C++ exceptions unsupported from throw in combining operation" );
+		} // try
+		combined_ += 1;
+		__atomic_store_n( &fifo->done, true, __ATOMIC_RELEASE );
+		fifo = next;
+	    } // while
+	} // for
+    } // uCombining::combine
+
+    void run( Request &request ) {
+	publish( request );
+	for ( unsigned int spin = 1; ! __atomic_load_n( &request.done, __ATOMIC_ACQUIRE ); spin += 1 ) {
+	    if ( ! __atomic_load_n( &combining, __ATOMIC_RELAXED ) && ! uFetchAssign( combining, true ) ) { // become combiner ?
+		combine();				// includes own request, published before acquiring
+		__atomic_store_n( &combining, false, __ATOMIC_RELEASE );
+	    } else if ( spin % Spins == 0 ) {
+		uBaseTask::yield();			// combiner may be on this processor
+	    } else {
+		uPause();
+	    } // if
+	} // for
+	if ( request.cause != nullptr ) {		// operation raised ?
+	    try {
+		request.cause->reraise();
+	    } _Finally {
+		delete request.cause;
+	    } // try
+	} // if
+    } // uCombining::run
+  public:
+    uCombining( const uCombining & ) = delete;		// no copy
+    uCombining( uCombining && ) = delete;
+    uCombining &operator=( const uCombining & ) = delete; // no assignment
+
+    template< typename... Args > uCombining( Args &&... args ) : object( std::forward< Args >( args )... ) {}
+
+    template< typename Func > auto operator()( Func action ) -> decltype(action( object )) { // run action on object
+	Call< Func, decltype(action( object )) > call( action );
+	run( call );
+	return call.result();
+    } // uCombining::operator()
+
+    // statistics, approximate while operations run
+    unsigned long int batches() const { return batches_; } // published lists run
+    unsigned long int combined() const { return combined_; } // operations run
+}; // uCombining
+
+
+#endif // __U_COMBINING_H__
+
+
+// Local Variables: //
+// compile-command: "make install" //
+// End: //
@@ -27,6 +27,8 @@
 #ifndef __U_FUTURE_H__
 #define __U_FUTURE_H__
 
+#include <atomic>
+
 
 //############################## uBaseFuture ##############################
 
@@ -59,7 +61,7 @@ namespace UPP {
 
 	void makeavailable() {
 	    available_ = true;
-	    while ( ! delay.empty() ) delay.signal();	// unblock waiting clients ?
+	    delay.signalAll();				// unblock waiting clients ?
 	    if ( ! selectClients.empty() ) {		// select-blocked clients ?
 		UPP::BaseFutureDL *bt;			// unblock select-blocked clients
 		for ( uSeqIter<UPP::BaseFutureDL> iter( selectClients ); iter >> bt; ) {
@@ -280,6 +282,12 @@ UPP::BinarySelector< UPP::BinarySelector< Left1, Right1 >, UPP::BinarySelector<
 
 
 // Future is responsible for storage management by using reference counts.  Can be copied.
+//
+// The future state is a single word: the list of waiting clients (initially empty) while the result is pending, or
+// Ready/Cancelled once the result, exception or cancellation is delivered. Waiting clients push themselves onto the
+// list with compare-and-swap and delivery swaps in the final state and wakes the list it removes, so neither polling
+// nor delivery takes a lock. A waiting client is a blocked task or a continuation added by then, which runs its
+// callback on an executor when the future is delivered rather than blocking a task. Only _Select clients use a lock.
 
 template<typename T> class Future_ISM {
   public:
@@ -288,48 +296,192 @@ template<typename T> class Future_ISM {
 	virtual bool cancel() = 0;
     };
   private:
-    _Monitor Impl : public UPP::uBaseFuture<T> {	// mutual exclusion implementation
-	using UPP::uBaseFuture<T>::cancelled_;
-	using UPP::uBaseFuture<T>::cause;
-
-	unsigned int refCnt;				// number of references to future
+    class Impl;
+
+    struct Waiter {					// client waiting for future result
+	Waiter *next;
+	virtual ~Waiter() {}
+	virtual void ready( Impl &impl ) = 0;		// called once by the delivering task
+    }; // Waiter
+
+    struct Blocked : public Waiter {			// task waiting in operator()
+	UPP::uSemaphore wake{ 0 };
+	void ready( Impl & ) { wake.V(); }		// V handles woken task deleting the semaphore
+    }; // Blocked
+
+    template< typename Executor, typename Func, typename R > struct Continuation : public Waiter { // added by then
+	Executor &executor;
+	Func action;
+	Future_ISM< R > next;				// result of action
+
+	Continuation( Executor &executor, Func action ) : executor( executor ), action( action ) {}
+
+	void ready( Impl &impl ) {
+	    Future_ISM< T > future( &impl );		// future passed to action, available
+	    Func action = Continuation::action;
+	    Future_ISM< R > next = Continuation::next;
+	    executor.send( [future, action, next]() mutable {
+		try {
+		    next.delivery( action( future ) );
+		} catch( uBaseEvent &ex ) {
+		    next.exception( ex.duplicate() );	// pass exception to the next future in the chain
+		} // try
+	    } );
+	    delete this;
+	} // Continuation::ready
+    }; // Continuation
+
+    class Impl {					// lock-free implementation
+	enum : uintptr_t { Ready = 1, Cancelled = 2 };	// state values that are not a waiter list
+
+	Waiter * volatile state;			// waiting clients or Ready/Cancelled
+	volatile bool claimed;				// result, exception or cancellation being delivered
+	volatile bool selecting;			// _Select clients registered
+	volatile unsigned int refCnt;			// number of references to future
 	ServerData *serverData;
-      public:
-	using UPP::uBaseFuture<T>::available;
-	using UPP::uBaseFuture<T>::reset;
-	using UPP::uBaseFuture<T>::makeavailable;
-	using UPP::uBaseFuture<T>::check;
-	using UPP::uBaseFuture<T>::delay;
-	using UPP::uBaseFuture<T>::cancelled;
+	uBaseEvent *cause;				// synchronous exception raised during future computation
+	T result;					// future result
+	uSpinLock selectLock;				// protect selectClients
+	uSequence<UPP::BaseFutureDL> selectClients;	// clients waiting for future result in selection
 
-	Impl() : refCnt( 1 ), serverData( nullptr ) {}
-	Impl( ServerData *serverData_ ) : refCnt( 1 ), serverData( serverData_ ) {}
+	static bool done( Waiter *s ) { return (uintptr_t)s == Ready || (uintptr_t)s == Cancelled; }
+
+	bool claim() {					// only one delivery, exception or cancellation succeeds
+	    return ! claimed && ! uFetchAssign( claimed, true );
+	} // Impl::claim
+
+	void makeavailable( uintptr_t final ) {
+	    Waiter *waiters = __atomic_exchange_n( &state, (Waiter *)final, __ATOMIC_SEQ_CST ); // publish result
+	    while ( waiters != nullptr ) {		// wake in reverse arrival order
+		Waiter *next = waiters->next;		// waiter may disappear when ready
+		waiters->ready( *this );
+		waiters = next;
+	    } // while
+	    if ( __atomic_load_n( &selecting, __ATOMIC_SEQ_CST ) ) { // select-blocked clients ?
+		selectLock.acquire();
+		UPP::BaseFutureDL *bt;			// unblock select-blocked clients
+		for ( uSeqIter<UPP::BaseFutureDL> iter( selectClients ); iter >> bt; ) {
+		    bt->signal();
+		} // for
+		selectLock.release();
+	    } // if
+	} // Impl::makeavailable
+      public:
+	Impl( ServerData *serverData = nullptr ) : state( nullptr ), claimed( false ), selecting( false ), refCnt( 1 ), serverData( serverData ), cause( nullptr ) {}
 
 	~Impl() {
+	    Waiter *waiters = state;			// continuations of a future never delivered
+	    if ( ! done( waiters ) ) {
+		while ( waiters != nullptr ) {
+		    Waiter *next = waiters->next;
+		    delete waiters;
+		    waiters = next;
+		} // while
+	    } // if
+	    delete cause;
 	    delete serverData;
 	} // Impl::~Impl
 
 	void incRef() {
-	    refCnt += 1;
+	    uFetchAdd( refCnt, 1 );
 	} // Impl::incRef
 
 	bool decRef() {
-	    refCnt -= 1;
-	  if ( refCnt != 0 ) return false;
-	    delete cause;
-	    return true;
+	    return uFetchAdd( refCnt, -1 ) == 1;
 	} // Impl::decRef
 
+	bool available() { return done( __atomic_load_n( &state, __ATOMIC_ACQUIRE ) ); } // future result available ?
+	bool cancelled() { return (uintptr_t)__atomic_load_n( &state, __ATOMIC_ACQUIRE ) == Cancelled; } // future result cancelled ?
+
+	void check() {
+	    if ( cancelled() ) _Throw uCancellation();
+	    if ( cause != nullptr ) cause->reraise();
+	} // Impl::check
+
+	bool wait( Waiter *waiter ) {			// false => available, waiter not added
+	    Waiter *head = __atomic_load_n( &state, __ATOMIC_ACQUIRE );
+	    for ( ;; ) {
+	      if ( done( head ) ) return false;
+		waiter->next = head;
+		if ( __atomic_compare_exchange_n( &state, &head, waiter, false, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE ) ) return true;
+	    } // for
+	} // Impl::wait
+
+	T operator()() {				// access result, possibly having to wait
+	    if ( ! available() ) {
+		Blocked blocked;
+		if ( wait( &blocked ) ) blocked.wake.P();
+	    } // if
+	    check();					// cancelled or exception ?
+	    return result;
+	} // Impl::operator()()
+
+	operator T() {					// cheap access of result after waiting
+	    check();					// cancelled or exception ?
+	    #ifdef __U_DEBUG__
+	    if ( ! available() ) {
+		abort( "Attempt to access future result %p without first performing a blocking access operation.", this );
+	    } // if
+	    #endif // __U_DEBUG__
+	    return result;
+	} // Impl::operator T()
+
+	bool addSelect( UPP::BaseFutureDL *selectState ) {
+	    selectLock.acquire();
+	    selecting = true;
+	    __atomic_thread_fence( __ATOMIC_SEQ_CST );	// order selecting before reading state, see makeavailable
+	    bool avail = available();
+	    if ( ! avail ) {
+		selectClients.addTail( selectState );
+	    } // if
+	    selectLock.release();
+	    return avail;
+	} // Impl::addSelect
+
+	void removeSelect( UPP::BaseFutureDL *selectState ) {
+	    selectLock.acquire();
+	    selectClients.remove( selectState );
+	    selectLock.release();
+	} // Impl::removeSelect
+
+	bool delivery( T res ) {			// make result available in the future
+	  if ( ! claim() ) return false;		// ignore, client does not want it or already set
+	    result = res;
+	    makeavailable( Ready );
+	    return true;
+	} // Impl::delivery
+
+	bool exception( uBaseEvent *ex ) {		// make exception available in the future : exception and result mutual exclusive
+	  if ( ! claim() ) return false;		// ignore, client does not want it or already set
+	    cause = ex;
+	    makeavailable( Ready );			// unblock waiting clients ?
+	    return true;
+	} // Impl::exception
+
 	void cancel() {					// cancel future result
-	  if ( available() ) return;			// already available, can't cancel
-	  if ( cancelled() ) return;			// only cancel once
-	    cancelled_ = true;
+	  if ( ! claim() ) return;			// already available or cancelled
 	    if ( serverData != nullptr ) serverData->cancel();
-	    makeavailable();				// unblock waiting clients ?
+	    makeavailable( Cancelled );			// unblock waiting clients ?
 	} // Impl::cancel
+
+	void reset() {					// mark future as empty (for reuse)
+	    #ifdef __U_DEBUG__
+	    if ( ! done( state ) && state != nullptr ) {
+		abort( "Attempt to reset future %p with waiting clients.", this );
+	    } // if
+	    #endif // __U_DEBUG__
+	    state = nullptr;				// reset for next value
+	    claimed = false;
+	    delete cause;
+	    cause = nullptr;
+	} // Impl::reset
     }; // Impl
 
     Impl *impl;						// storage for implementation
+
+    Future_ISM( Impl *impl ) : impl( impl ) {		// additional reference
+	impl->incRef();
+    } // Future_ISM::Future_ISM
   public:
     Future_ISM() : impl( new Impl ) {}
     Future_ISM( ServerData *serverData ) : impl( new Impl( serverData ) ) {}
@@ -368,6 +520,17 @@ template<typename T> class Future_ISM {
 	impl->cancel();
     } // Future_ISM::cancel
 
+    // When this future is delivered, send action to executor (e.g., uExecutor), which calls action with this future,
+    // now available, and delivers action's result or exception to the returned future. If this future is already
+    // available, action is sent immediately. Continuations chain without a blocked task per step.
+    template< typename Executor, typename Func > auto then( Executor &executor, Func action ) -> Future_ISM< decltype(action( *this )) > {
+	typedef decltype(action( *this )) R;
+	Continuation< Executor, Func, R > *continuation = new Continuation< Executor, Func, R >( executor, action );
+	Future_ISM< R > next = continuation->next;	// race, copy before adding
+	if ( ! impl->wait( continuation ) ) continuation->ready( *impl ); // already available ?
+	return next;
+    } // Future_ISM::then
+
     bool addSelect( UPP::BaseFutureDL *selectState ) {
 	return impl->addSelect( selectState );
     } // Future_ISM::addSelect
@@ -618,175 +781,457 @@ class uExecutor {
 
     #define CALIGN __attribute__(( aligned (64) ))
 
-//#define LOCKFREE
-#if defined( LOCKFREE )
-    // http://www.1024cores.net/home/lock-free-algorithms/queues/intrusive-mpsc-node-based-queue
-
-    #define UCOLABLE Buffer_Colable
+    // Mailbox implementations, selected per executor at construction.
 
-    struct Buffer_Colable {
-	Buffer_Colable * volatile next;
+    struct Buffer_Colable {				// link for lock-free mailbox
+	std::atomic< Buffer_Colable * > next;
     }; // Buffer_Colable
 
-    template< typename ELEMTYPE > class Buffer {
-      protected:
-	ELEMTYPE pad1 CALIGN, * volatile head CALIGN, * tail CALIGN, stub CALIGN, pad2 CALIGN;
-      public:
-	Buffer() {
-	    tail = head = &stub;
-	    stub.next = 0;
-	} // Buffer::Buffer
-
-	void insert( ELEMTYPE * n ) {
-	    n->next = 0;
-	    ELEMTYPE * prev = __sync_lock_test_and_set( &head, n );
+    // Intrusive multi-producer single-consumer queue (Vyukov), one atomic exchange per insert and no atomic
+    // read-modify-write per remove. Workers and thieves only remove while holding the mailbox claim, which serializes
+    // the consumers.  http://www.1024cores.net/home/lock-free-algorithms/queues/intrusive-mpsc-node-based-queue
+    template< typename ELEMTYPE > class LockFreeBuffer {
+	std::atomic< Buffer_Colable * > head CALIGN;	// producers
+	std::atomic< Buffer_Colable * > tail CALIGN;	// consumer, relaxed as only read by others in empty
+	Buffer_Colable stub;
+
+	Buffer_Colable * push( Buffer_Colable * n ) {
+	    n->next.store( nullptr, std::memory_order_relaxed );
+	    Buffer_Colable * prev = head.exchange( n, std::memory_order_acq_rel );
 	    //(*)
-	    prev->next = n;
-	} // Buffer::insert
-
-	ELEMTYPE * remove() {
-	    ELEMTYPE * tail_ = tail, * next_ = (ELEMTYPE *)(tail_->next);
-	    if ( tail_ == &stub ) {
-	  if ( next_ == nullptr ) return nullptr;
-		tail = next_;
+	    prev->next.store( n, std::memory_order_release ); // publish node to consumer
+	    return prev;
+	} // LockFreeBuffer::push
+      public:
+	LockFreeBuffer() : head( &stub ), tail( &stub ) {
+	    stub.next.store( nullptr, std::memory_order_relaxed );
+	} // LockFreeBuffer::LockFreeBuffer
+
+	void *operator new[]( size_t size ) {
+	    return ::memalign( uCacheLine(), size );	// size of cache line to prevent false sharing
+	} // LockFreeBuffer::operator new
+
+	bool insert( ELEMTYPE * n ) {			// true => buffer may have been empty
+	    return push( n ) == &stub;			// only stub ahead => consumer may have found buffer empty
+	} // LockFreeBuffer::insert
+
+	bool empty() {
+	    // An element in flight at (*) is not seen, but its producer found the stub ahead and checks for a parked
+	    // worker, or an earlier element is still in the queue.
+	    return tail.load( std::memory_order_relaxed ) == &stub && stub.next.load( std::memory_order_acquire ) == nullptr;
+	} // LockFreeBuffer::empty
+
+	ELEMTYPE * remove() {				// claim holder only
+	    Buffer_Colable * tail_ = tail.load( std::memory_order_relaxed ), * next_ = tail_->next.load( std::memory_order_acquire );
+	    if ( tail_ == &stub ) {			// skip stub
+	      if ( next_ == nullptr ) return nullptr;	// empty
 		tail_ = next_;
-		next_ = (ELEMTYPE *)(next_->next);
+		tail.store( tail_, std::memory_order_relaxed );
+		next_ = next_->next.load( std::memory_order_acquire );
 	    } // if
-
-	    if ( next_ ) {
-		tail = next_;
-		return tail_;
+	    if ( next_ != nullptr ) {
+		tail.store( next_, std::memory_order_relaxed );
+		return static_cast< ELEMTYPE * >( tail_ );
 	    } // if
-
-	    Buffer_Colable * head_ = head;
-	  if ( tail_ != head_ ) return nullptr;
-	    insert( &stub );
-	    next_ = (ELEMTYPE *)(tail_->next);
-	  if ( next_ ) { tail = next_; return tail_; }
-	    return nullptr;
-	} // Buffer::remove
-    }; // Buffer
-
-#elif defined( SPINLOCK )
-
-    #define UCOLABLE uColable
-    template< typename ELEMTYPE > class Buffer {	// unbounded buffer
-	uSpinLock mutex;
+	    // tail_ is the last element; requeue the stub behind it so it can be removed.
+	  if ( tail_ != head.load( std::memory_order_acquire ) ) return nullptr; // producer at (*) => retry later
+	    push( &stub );
+	    next_ = tail_->next.load( std::memory_order_acquire );
+	  if ( next_ == nullptr ) return nullptr;	// producer at (*) => retry later
+	    tail.store( next_, std::memory_order_relaxed );
+	    return static_cast< ELEMTYPE * >( tail_ );
+	} // LockFreeBuffer::remove
+    }; // LockFreeBuffer
+
+    template< typename ELEMTYPE > class SpinLockBuffer { // unbounded buffer
+	uSpinLock mutex __attribute__(( aligned (uCacheLine()) )); // adjacent mailboxes are used by different workers
 	uQueue< ELEMTYPE > buf;				// unbounded list of work requests
       public:
-	void insert( ELEMTYPE *elem ) {
+	void *operator new[]( size_t size ) {
+	    return ::memalign( uCacheLine(), size );	// size of cache line to prevent false sharing
+	} // SpinLockBuffer::operator new
+
+	bool insert( ELEMTYPE *elem ) {			// true => buffer was empty
 	    mutex.acquire();
+	    bool wasEmpty = buf.empty();
 	    buf.addTail( elem );			// insert element into buffer
 	    mutex.release();
-	} // Buffer::insert
+	    return wasEmpty;
+	} // SpinLockBuffer::insert
+
+	bool empty() {
+	    return buf.empty();				// racy read, rechecked by remove
+	} // SpinLockBuffer::empty
 
 	ELEMTYPE *remove() {
 	    mutex.acquire();
 	    ELEMTYPE *ret = buf.dropHead();
 	    mutex.release();
 	    return ret;
-	} // Buffer::remove
-    }; // Buffer
-
-#else // monitor
+	} // SpinLockBuffer::remove
+    }; // SpinLockBuffer
 
-    #define UCOLABLE uColable
-    template< typename ELEMTYPE > _Monitor Buffer {	// unbounded buffer
-	uQueue< ELEMTYPE > buf;				// unbounded list of work requests
+    template< typename ELEMTYPE > _Monitor MonitorBuffer { // unbounded buffer
+	uQueue< ELEMTYPE > buf __attribute__(( aligned (uCacheLine()) )); // adjacent mailboxes are used by different workers
 	uCondition delay;
       public:
-	void insert( ELEMTYPE *elem ) {
+	void *operator new[]( size_t size ) {
+	    return ::memalign( uCacheLine(), size );	// size of cache line to prevent false sharing
+	} // MonitorBuffer::operator new
+
+	bool insert( ELEMTYPE *elem ) {			// true => buffer was empty
+	    bool wasEmpty = buf.empty();
 	    buf.addTail( elem );			// insert element into buffer
 	    delay.signal();				// restart
-	} // Buffer::insert
+	    return wasEmpty;
+	} // MonitorBuffer::insert
+
+	bool empty() {
+	    return buf.empty();
+	} // MonitorBuffer::empty
 
 	ELEMTYPE * remove() {
 //	    if ( buf.empty() ) delay.wait();		// no request to process ? => wait
 	    if ( buf.empty() ) return nullptr;		// no request to process ? => 
 	    return buf.dropHead();
-	} // Buffer::remove
-    }; // Buffer
-
-#endif // LOCKTYPE
-
-    struct WRequest : public UCOLABLE {			// worker request
+	} // MonitorBuffer::remove
+    }; // MonitorBuffer
+  public:
+    enum Mailbox { LockFree, SpinLock, Monitor };	// mailbox implementations
+  private:
+    template< typename ELEMTYPE > struct Buffers {	// mailboxes of one implementation, dispatched at runtime
+	const Mailbox kind;
+	union {
+	    LockFreeBuffer< ELEMTYPE > * lockfree;
+	    SpinLockBuffer< ELEMTYPE > * spinlock;
+	    MonitorBuffer< ELEMTYPE > * monitor;
+	};
+
+	Buffers( Mailbox kind, unsigned int nmailboxes ) : kind( kind ) {
+	    switch ( kind ) {
+	      case LockFree: lockfree = new LockFreeBuffer< ELEMTYPE >[ nmailboxes ]; break;
+	      case SpinLock: spinlock = new SpinLockBuffer< ELEMTYPE >[ nmailboxes ]; break;
+	      case Monitor: monitor = new MonitorBuffer< ELEMTYPE >[ nmailboxes ]; break;
+	    } // switch
+	} // Buffers::Buffers
+
+	~Buffers() {
+	    switch ( kind ) {
+	      case LockFree: delete [] lockfree; break;
+	      case SpinLock: delete [] spinlock; break;
+	      case Monitor: delete [] monitor; break;
+	    } // switch
+	} // Buffers::~Buffers
+
+	bool insert( unsigned int mailbox, ELEMTYPE * elem ) {
+	    switch ( kind ) {
+	      case LockFree: return lockfree[mailbox].insert( elem );
+	      case SpinLock: return spinlock[mailbox].insert( elem );
+	      default: return monitor[mailbox].insert( elem );
+	    } // switch
+	} // Buffers::insert
+
+	bool empty( unsigned int mailbox ) {
+	    switch ( kind ) {
+	      case LockFree: return lockfree[mailbox].empty();
+	      case SpinLock: return spinlock[mailbox].empty();
+	      default: return monitor[mailbox].empty();
+	    } // switch
+	} // Buffers::empty
+
+	ELEMTYPE * remove( unsigned int mailbox ) {
+	    switch ( kind ) {
+	      case LockFree: return lockfree[mailbox].remove();
+	      case SpinLock: return spinlock[mailbox].remove();
+	      default: return monitor[mailbox].remove();
+	    } // switch
+	} // Buffers::remove
+    }; // Buffers
+
+    // Request nodes of at most NodeSize bytes are recycled through per-worker pools instead of the heap. The worker
+    // executing a request returns its node to a private list, handed to the worker's pool in batches; a sender takes a
+    // node from the pool of the worker owning the destination mailbox, carving a new slab when the pool is empty.
+    enum { NodeSize = 64, SlabNodes = 64, PoolBatch = 32 };
+
+    union Node {
+	Node * next;					// free-list link
+	char storage[NodeSize];
+    }; // Node
+
+    struct NodePool {
+	uSpinLock lock CALIGN;				// senders and owning worker
+	Node * free = nullptr;				// protected by lock
+	Node * local = nullptr, * localTail = nullptr;	// owning worker only
+	unsigned int nlocal = 0;
+	unsigned int home;				// first mailbox of owning worker, for requests preferring this worker
+
+	void *operator new[]( size_t size ) {
+	    return ::memalign( uCacheLine(), size );	// size of cache line to prevent false sharing
+	} // NodePool::operator new
+
+	void * alloc( uExecutor & executor ) {		// sender
+	    lock.acquire();
+	    Node * node = free;
+	    if ( node != nullptr ) free = node->next;
+	    lock.release();
+	    return node != nullptr ? node : executor.slab( *this );
+	} // NodePool::alloc
+
+	void recycle( void * storage ) {		// executing worker
+	    Node * node = (Node *)storage;
+	    node->next = local;
+	    if ( local == nullptr ) localTail = node;
+	    local = node;
+	    nlocal += 1;
+	    if ( nlocal == PoolBatch ) flush();
+	} // NodePool::recycle
+
+	void flush() {					// executing worker, one lock acquisition per batch
+	  if ( local == nullptr ) return;
+	    lock.acquire();
+	    localTail->next = free;
+	    free = local;
+	    lock.release();
+	    local = localTail = nullptr;
+	    nlocal = 0;
+	} // NodePool::flush
+    }; // NodePool
+
+    struct WRequest : public uColable, public Buffer_Colable { // worker request, linkable in any mailbox
 	virtual ~WRequest() {};				// required for FRequest's result
-	virtual bool stop() { return true; };
-	virtual void doit() { assert( false ); };	// not abstract as used for sentinel
+	// Execute the request and dispose of it; the worker does not touch the request afterwards.
+	virtual void doit( NodePool & ) = 0;
     }; // WRequest
 
+    template< typename Request > static constexpr bool pooled() {
+	return sizeof(Request) <= sizeof(Node) && alignof(Request) <= alignof(Node);
+    } // uExecutor::pooled
+
+    template< typename Request > static void release( Request * request, NodePool & pool ) {
+	if ( pooled< Request >() ) {
+	    request->~Request();
+	    pool.recycle( request );
+	} else {
+	    delete request;
+	} // if
+    } // uExecutor::release
+
     template< typename F > struct VRequest : public WRequest { // client request, no return
 	F action;
-	bool stop() { return false; };
-	void doit() { action(); }
+	void doit( NodePool & pool ) { action(); release( this, pool ); }
 	VRequest( F action ) : action( action ) {}
     }; // VRequest
 
     template< typename R, typename F > struct FRequest : public WRequest { // client request, return
 	F action;
 	Future_ISM< R > result;
-	bool stop() { return false; };
-	void doit() { result.delivery( action() ); }
+	void doit( NodePool & pool ) {
+	    try {
+		result.delivery( action() );
+	    } catch( uBaseEvent &ex ) {
+		result.exception( ex.duplicate() );	// raised at client when result accessed
+	    } // try
+	    release( this, pool );
+	} // FRequest::doit
 	FRequest( F action ) : action( action ) {}
     }; // FRequest
 
+    // An idle worker spins over its mailboxes briefly and then parks on its own semaphore. A sender wakes the owning
+    // worker only when its insert makes a mailbox non-empty and the worker is parked, so the busy path never blocks.
+    struct Idle {
+	volatile bool parked CALIGN = false;		// read by senders, so each worker's flag has its own cache line
+	volatile bool stopping = false;			// set by the worker's stop request
+	UPP::uSemaphore wake{ 0 };
+#ifdef __U_STATISTICS__
+	unsigned long int stealAttempts = 0, steals = 0, stolen = 0; // written by owning worker only
+#endif // __U_STATISTICS__
+
+	void *operator new[]( size_t size ) {
+	    return ::memalign( uCacheLine(), size );	// size of cache line to prevent false sharing
+	} // Idle::operator new
+
+	void unpark() {					// sender
+	    __atomic_thread_fence( __ATOMIC_SEQ_CST );	// order insert before reading parked
+	    if ( parked && uFetchAssign( parked, false ) ) wake.V(); // only one sender wakes the worker
+	} // Idle::unpark
+    }; // Idle
+
+    struct Stop : public WRequest {			// sentinel, possibly run by a thief
+	Idle * idle;
+	void doit( NodePool & ) { idle->stopping = true; idle->unpark(); }
+    }; // Stop
+
+    // A worker (or thief) runs requests from a mailbox only while holding its claim, so the requests of an actor,
+    // which all go to the actor's mailbox, are never run by two workers at once and run in arrival order.
+    struct Claim {
+	volatile bool busy CALIGN = false;
+
+	void *operator new[]( size_t size ) {
+	    return ::memalign( uCacheLine(), size );	// size of cache line to prevent false sharing
+	} // Claim::operator new
+    }; // Claim
+
     // Each worker has its own work buffer to reduce contention between client and server. Hence, work requests arrive
-    // and are distributed into buffers in a roughly round-robin order.
+    // and are distributed into buffers in a roughly round-robin order. A worker whose mailboxes run dry steals a batch
+    // of requests from a mailbox of another worker before spinning and parking.
     template< typename ELEMTYPE > _Task Worker {
-	Buffer< WRequest > * requests;
-	unsigned int start, range;
+	enum { SpinSweeps = 64,				// empty sweeps over mailboxes before parking
+	       StealScan = 16,				// victim mailboxes examined per steal attempt
+	       StealBatch = 32,				// requests run per successful steal
+	       WakeCheck = 64 };			// requests run between checks for a backlog
+	uExecutor & executor;
+	unsigned int id, start, range, victim;
+	Idle & idle;
+	NodePool & pool;
+
+	unsigned int serve( unsigned int mailbox, unsigned int batch ) { // number of requests run
+	    Claim & claim = executor.claims[mailbox];
+	  if ( uTestSet( claim.busy ) ) return 0;	// owner or thief running mailbox ?
+	    unsigned int n;
+	    for ( n = 0; n < batch; n += 1 ) {
+		WRequest * request = executor.requests->remove( mailbox );
+	      if ( ! request ) break;
+		request->doit( pool );			// request disposes of itself
+	    } // for
+	    uTestReset( claim.busy );
+	    return n;
+	} // Worker::serve
+
+	bool steal() {
+	    for ( unsigned int t = 0; t < StealScan && t < executor.nmailboxes; t += 1 ) {
+		victim = ( victim + 1 ) % executor.nmailboxes;
+	      if ( executor.owners[victim] == id ) continue; // own mailbox ?
+	      if ( executor.requests->empty( victim ) ) continue;
+#ifdef __U_STATISTICS__
+		idle.stealAttempts += 1;
+#endif // __U_STATISTICS__
+		unsigned int n = serve( victim, StealBatch );
+		if ( n != 0 ) {
+#ifdef __U_STATISTICS__
+		    idle.steals += 1;
+		    idle.stolen += n;
+#endif // __U_STATISTICS__
+		    return true;
+		} // if
+	    } // for
+	    return false;
+	} // Worker::steal
+
+	void park() {
+	    pool.flush();				// make recycled nodes available to senders
+	    idle.parked = true;
+	    __atomic_thread_fence( __ATOMIC_SEQ_CST );	// publish parked before rechecking mailboxes
+	    for ( unsigned int i = 0; i < range; i += 1 ) {
+		if ( ! executor.requests->empty( i + start ) || idle.stopping ) { // request arrived before sender saw parked ?
+		    if ( ! uFetchAssign( idle.parked, false ) ) idle.wake.P(); // sender unparked => consume its wakeup
+		    return;
+		} // if
+	    } // for
+	    idle.wake.P();				// sender clears parked
+	} // Worker::park
 
 	void main() {
-	    for ( int i = 0;; i = (i + 1) % range ) {
-		WRequest *request = requests[i + start].remove();
-	      if ( ! request ) {
-		    #if ! defined( __U_MULTI__ )
-		    uThisTask().uYieldNoPoll();
-		    #endif // ! __U_MULTI__
+	    unsigned int empty = 0, run = 0;
+	    for ( unsigned int i = 0; ! idle.stopping; i = (i + 1) % range ) {
+		unsigned int n = serve( i + start, 1 );
+		if ( n != 0 ) {
+		    empty = 0;
+		    run += n;
+		    if ( run >= WakeCheck ) {		// busy for a while ?
+			run = 0;
+			// Backlog in this mailbox => wake a parked neighbour to steal from other mailboxes.
+			if ( ! executor.requests->empty( i + start ) ) executor.idles[(id + 1) % executor.nworkers].unpark();
+		    } // if
 		    continue;
 		} // if
-	      if ( request->stop() ) break;
-		request->doit();
-		delete request;
+		empty += 1;
+	      if ( empty % range != 0 ) continue;	// finish sweep over own mailboxes
+		if ( steal() ) {
+		    empty = 0;
+		} else if ( empty < range * SpinSweeps ) {
+		    #if defined( __U_MULTI__ )
+		    uPause();
+		    #else
+		    uThisTask().uYieldNoPoll();
+		    #endif // __U_MULTI__
+		} else {
+		    park();
+		    empty = 0;
+		} // if
 	    } // for
 	} // Worker::main
       public:
-	Worker( uCluster & wc, Buffer< WRequest > * requests, unsigned int start, unsigned int range ) :
-	    uBaseTask( wc ), requests( requests ), start( start ), range( range ) {}
+	Worker( uCluster & wc, uExecutor & executor, unsigned int id, unsigned int start, unsigned int range ) :
+	    uBaseTask( wc ), executor( executor ), id( id ), start( start ), range( range ), victim( start + range - 1 ),
+	    idle( executor.idles[id] ), pool( executor.pools[id] ) {}
     }; // Worker
 
     enum { DefaultWorkers = 8, DefaultProcessors = 4 };
     uCluster *cluster;					// if workers execute on separate cluster
     uProcessor **processors;				// array of virtual processors adding parallelism for workers
-    Buffer< WRequest > *requests;			// list of work requests
+    Buffers< WRequest > *requests;			// list of work requests
     Worker< WRequest > **workers;			// array of workers executing work requests
+    Idle *idles;					// parking state, one per worker
+    Claim *claims;					// mailbox claims, one per mailbox
+    NodePool *pools;					// request-node pools, one per worker
+    unsigned int *owners;				// worker owning each mailbox
+    uSpinLock slabLock;
+    Node *slabs = nullptr;				// first node of each slab links the slabs
     const unsigned int nmailboxes, nworkers, nprocessors; // number of mailboxes/workers/processor tasks
     const bool sepClus;					// use same or separate cluster for executor
-    unsigned int next = 0;				// demultiplexed across workers buffers
+    // Every client writes next, so it is kept off the cache line of the read-only fields above.
+    unsigned int next __attribute__(( aligned (uCacheLine()) )) = 0; // demultiplexed across workers buffers
 
     unsigned int tickets() {
 	//return uFetchAdd( next, 1 ) % nmailboxes;
 	return next++ % nmailboxes;			// no locking, interference randomizes
     } // uExecutor::tickets
 
+    void *slab( NodePool & pool ) {			// sender, pool empty
+	Node * nodes = (Node *)::memalign( uCacheLine(), SlabNodes * sizeof(Node) );
+	slabLock.acquire();
+	nodes[0].next = slabs;
+	slabs = &nodes[0];
+	slabLock.release();
+	for ( unsigned int i = 2; i < SlabNodes - 1; i += 1 ) nodes[i].next = &nodes[i + 1];
+	pool.lock.acquire();
+	nodes[SlabNodes - 1].next = pool.free;
+	pool.free = &nodes[2];
+	pool.lock.release();
+	return &nodes[1];
+    } // uExecutor::slab
+
+    template< typename Request, typename Func > Request * request( Func action, unsigned int ticket ) {
+	if ( pooled< Request >() ) return new( pools[owners[ticket]].alloc( *this ) ) Request( action );
+	return new Request( action );
+    } // uExecutor::request
+
+    void insert( WRequest *node, unsigned int ticket ) {
+	if ( requests->insert( ticket, node ) ) idles[owners[ticket]].unpark(); // mailbox was empty => worker may be parked
+    } // uExecutor::insert
+
     template< typename Func > void send( Func action, unsigned int ticket ) { // asynchronous call, no return value
-	VRequest< Func > *node = new VRequest< Func >( action );
-	requests[ticket].insert( node );
+	VRequest< Func > *node = request< VRequest< Func > >( action, ticket );
+	insert( node, ticket );
     } // uExecutor::send
 
     template< typename Func > auto sendrecv( Func action, unsigned int ticket ) -> Future_ISM< decltype(action()) > { // asynchronous call, return value (future)
-	FRequest< decltype(action()), Func > *node = new FRequest< decltype(action()), Func >( action );
+	FRequest< decltype(action()), Func > *node = request< FRequest< decltype(action()), Func > >( action, ticket );
 	Future_ISM< decltype(action()) > result = node->result;	// race, copy before insert
-	requests[ticket].insert( node );
+	insert( node, ticket );
 	return result;
     } // uExecutor::sendrecv
   public:
-    uExecutor( unsigned int nmailboxes, unsigned int nworkers, unsigned int nprocessors, int affOffset, bool sepClus = false ) : nmailboxes( nmailboxes ), nworkers( nworkers ), nprocessors( nprocessors ), sepClus( sepClus ) {
+    uExecutor( unsigned int nmailboxes, unsigned int nworkers, unsigned int nprocessors, int affOffset, bool sepClus = false, Mailbox mailbox = LockFree ) : nmailboxes( nmailboxes ), nworkers( nworkers ), nprocessors( nprocessors ), sepClus( sepClus ) {
 	assert( nmailboxes >= nworkers );
 	cluster = sepClus ? new uCluster( "uExecutor" ) : &uThisCluster();
 	processors = new uProcessor *[ nprocessors ];
-	requests = new Buffer< WRequest >[ nmailboxes ];
+	requests = new Buffers< WRequest >( mailbox, nmailboxes );
 	workers = new Worker< WRequest > *[ nworkers ];
+	idles = new Idle[ nworkers ];
+	pools = new NodePool[ nworkers ];
+	claims = new Claim[ nmailboxes ];
+	owners = new unsigned int[ nmailboxes ];
 
 	for ( unsigned int i = 0; i < nprocessors; i += 1 ) {
 	    processors[ i ] = new uProcessor( *cluster );
@@ -797,11 +1242,13 @@ class uExecutor {
 
 	unsigned int reqPerWorker = nmailboxes / nworkers, extras = nmailboxes % nworkers;
 	for ( unsigned int i = 0, step = 0; i < nworkers; i += 1, step += reqPerWorker + ( i < extras ? 1 : 0 ) ) {
-	    workers[ i ] = new Worker< WRequest >( *cluster, requests, step, reqPerWorker + ( i < extras ? 1 : 0 ) );
+	    for ( unsigned int m = 0; m < reqPerWorker + ( i < extras ? 1 : 0 ); m += 1 ) owners[ step + m ] = i;
+	    pools[ i ].home = step;
+	    workers[ i ] = new Worker< WRequest >( *cluster, *this, i, step, reqPerWorker + ( i < extras ? 1 : 0 ) );
 	} // for
     } // uExecutor::uExecutor
 
-    uExecutor( unsigned int nworkers, unsigned int nprocessors, int affOffset, bool sepClus = false ) : uExecutor( nworkers, nworkers, nprocessors, affOffset, sepClus ) {}
+    uExecutor( unsigned int nworkers, unsigned int nprocessors, int affOffset, bool sepClus = false, Mailbox mailbox = LockFree ) : uExecutor( nworkers, nworkers, nprocessors, affOffset, sepClus, mailbox ) {}
     uExecutor( unsigned int nworkers, unsigned int nprocessors, bool sepClus = false ) : uExecutor( nworkers, nworkers, nprocessors, -1, sepClus ) {}
     uExecutor( unsigned int nworkers, bool sepClus = false ) : uExecutor( nworkers, DefaultProcessors, sepClus ) {}
     uExecutor( bool sepClus ) : uExecutor( DefaultWorkers, DefaultProcessors, sepClus ) {}
@@ -811,10 +1258,11 @@ class uExecutor {
 	// Add one sentinel per worker to stop them. Since in destructor, no new work should be queued.  Cannot combine
 	// next two loops and only have a single sentinel because workers arrive in arbitrary order, so worker1 may take
 	// the single sentinel while waiting for worker 0 to end.
-	WRequest sentinel[nworkers];
-	unsigned int reqPerWorker = nmailboxes / nworkers;
-	for ( unsigned int i = 0, step = 0; i < nworkers; i += 1, step += reqPerWorker ) {
-	    requests[step].insert( &sentinel[i] );	// force eventually termination
+	Stop sentinel[nworkers];
+	unsigned int reqPerWorker = nmailboxes / nworkers, extras = nmailboxes % nworkers;
+	for ( unsigned int i = 0, step = 0; i < nworkers; i += 1, step += reqPerWorker + ( i < extras ? 1 : 0 ) ) {
+	    sentinel[i].idle = &idles[i];
+	    insert( &sentinel[i], step );		// force eventually termination, waking parked worker
 	} // for
 	for ( unsigned int i = 0; i < nworkers; i += 1 ) {
 	    delete workers[ i ];
@@ -823,12 +1271,30 @@ class uExecutor {
 	    delete processors[ i ];
 	} // for
 
+	for ( Node * slab = slabs; slab != nullptr; ) {	// pooled request nodes
+	    Node * next = slab->next;
+	    ::free( slab );
+	    slab = next;
+	} // for
+
 	delete [] workers;
-	delete [] requests;
+	delete [] owners;
+	delete [] claims;
+	delete [] pools;
+	delete [] idles;
+	delete requests;
 	delete [] processors;
 	if ( sepClus ) { delete cluster; }
     } // uExecutor::~uExecutor
 
+    void *operator new( size_t size ) {			// c++14 new ignores over-alignment
+	return ::memalign( uCacheLine(), size );
+    } // uExecutor::operator new
+
+    void operator delete( void *storage ) {
+	::free( storage );
+    } // uExecutor::operator delete
+
     template< typename Func > void send( Func action ) { // asynchronous call, no return value
 	send( action, tickets() );
     } // uExecutor::send
@@ -837,8 +1303,26 @@ class uExecutor {
     template< typename Func > auto sendrecv( Func action ) -> Future_ISM< decltype(action()) > { // asynchronous call, return value (future)
 	return sendrecv( action, tickets() );
     } // uExecutor::sendrecv
+
+#ifdef __U_STATISTICS__
+    struct StealStats {
+	unsigned long int attempts, steals, stolen;	// mailboxes claimed, claims with work, requests run by thieves
+    }; // StealStats
+
+    StealStats stealStats() const {			// approximate while workers are running
+	StealStats sum = { 0, 0, 0 };
+	for ( unsigned int i = 0; i < nworkers; i += 1 ) {
+	    sum.attempts += idles[i].stealAttempts;
+	    sum.steals += idles[i].steals;
+	    sum.stolen += idles[i].stolen;
+	} // for
+	return sum;
+    } // uExecutor::stealStats
+#endif // __U_STATISTICS__
 }; // uExecutor
 
+static_assert( alignof(uExecutor) == uCacheLine(), "uExecutor is not cache-line aligned" );
+
 
 #endif // __U_FUTURE_H__
 
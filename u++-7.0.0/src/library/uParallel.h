@@ -0,0 +1,340 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 7.0.0, Copyright (C) Peter A. Buhr 2018
+//
+// uParallel.h -- Parallel algorithms running on the processors of a cluster.
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+
+#ifndef __U_PARALLEL_H__
+#define __U_PARALLEL_H__
+
+#include <uCobegin.h>					// uCoforRanges
+#include <algorithm>					// sort, merge
+#include <iterator>					// iterator_traits, make_move_iterator
+#include <vector>
+
+#pragma __U_NOT_USER_CODE__
+
+// The algorithms take random-access iterators and an optional cluster, defaulting to the calling task's cluster, whose
+// processors run the algorithm:
+//
+//   uParallel::for_each( first, last, f )
+//   uParallel::transform( first, last, out, op )
+//   uParallel::reduce( first, last, init, op )
+//   uParallel::transform_reduce( first, last, init, reduce, transform )
+//   uParallel::inclusive_scan( first, last, out, op )
+//   uParallel::sort( first, last [, comp ] )
+//
+// The grain size is tuned for each call: the calling task runs a few elements, doubling the count until the time
+// reaches Target, and the remaining elements are split into chunks of about Target time. A call whose work takes less
+// than Target runs sequentially, and otherwise one worker task per processor, as needed, runs the chunks with work
+// stealing (see COFOR). reduce, transform_reduce and inclusive_scan apply op in an unspecified order, so op must be
+// associative, and for the reductions commutative.
+
+namespace UPP {
+    template<typename Work> _Task uParallelWorker {
+	Work &work;					// worker loop
+	unsigned int id;				// worker range
+
+	void main() { work( id ); }
+      public:
+	uParallelWorker( uCluster &cluster, Work &work, unsigned int id ) : uBaseTask( cluster ), work( work ), id( id ) {}
+    }; // uParallelWorker
+
+    // Call body( low, high, worker ) for disjoint ranges covering [0, size), with worker less than workers.
+    template<typename Body> void uParallelFor( uCluster &cluster, size_t size, unsigned int workers, Body &body ) {
+	enum { Target = 50000,				// nanoseconds of work per chunk
+	       Slab = 1u << 31 };			// maximum range for uCoforRanges
+
+	size_t done = 0;
+	long long int spent = 0;			// nanoseconds to run done elements
+	for ( size_t probe = 1; done < size && spent < Target; probe *= 2 ) { // sample cost in calling task
+	    size_t n = size - done < probe ? size - done : probe;
+	    uTime start = uThisProcessor().getClock().getTime();
+	    body( done, done + n, 0 );
+	    spent += ( uThisProcessor().getClock().getTime() - start ).nanoseconds();
+	    done += n;
+	} // for
+      if ( done == size ) return;			// short work, sequential
+
+	size_t grain = spent > 0 ? done * Target / spent : size;
+	if ( grain == 0 ) grain = 1;
+	size_t chunks = ( size - done + grain - 1 ) / grain;
+	if ( workers > chunks ) workers = chunks;	// no idle workers
+	if ( workers <= 1 ) {
+	    body( done, size, 0 );
+	    return;
+	} // if
+
+	const bool caller = &uThisCluster() == &cluster; // calling task can be a worker ?
+	for ( size_t base = done; base < size; base += Slab ) {
+	    unsigned int slab = size - base < Slab ? size - base : Slab;
+	    UPP::uCoforRanges ranges( slab, workers, grain < slab ? grain : slab );
+	    auto work = [&]( unsigned int id ) {
+		for ( unsigned int low, high; ranges.next( id, low, high ); ) body( base + low, base + high, id );
+	    };
+	    typedef uParallelWorker< decltype(work) > Worker;
+
+	    struct Join {				// wait for helpers even if the body raises an exception (see uCofor)
+		Worker **helpers;
+		unsigned int size;
+		void wait() {
+		    for ( unsigned int id = 0; id < size; id += 1 ) {
+			Worker *helper = helpers[id];	// null if not created or already deleted
+			helpers[id] = nullptr;
+			delete helper;
+		    } // for
+		} // Join::wait
+		~Join() noexcept(false) {
+		    wait();
+		    delete [] helpers;
+		} // Join::~Join
+	    } join = { new Worker *[workers](), workers };	// do not use up task stack
+
+	    for ( unsigned int id = caller; id < workers; id += 1 ) join.helpers[id] = new Worker( cluster, work, id );
+	    if ( caller ) work( 0 );
+	    join.wait();				// outside the destructor, so a helper exception propagates normally
+	} // for
+    } // uParallelFor
+
+    template<typename T> class uParallelPartials {	// per worker result, separate cache lines
+	struct Partial {
+	    T value;
+	    bool used;					// value holds a result
+	    Partial( const T &init ) : value( init ), used( false ) {}
+	} __attribute__(( aligned (uCacheLine()) ));
+
+	Partial *partials;
+	unsigned int size;
+      public:
+	uParallelPartials( const uParallelPartials & ) = delete; // no copy
+	uParallelPartials( uParallelPartials && ) = delete;
+	uParallelPartials &operator=( const uParallelPartials & ) = delete; // no assignment
+
+	uParallelPartials( unsigned int size, const T &init ) : size( size ) {
+	    partials = (Partial *)::memalign( uCacheLine(), size * sizeof(Partial) );
+	    for ( unsigned int i = 0; i < size; i += 1 ) new( &partials[i] ) Partial( init );
+	} // uParallelPartials::uParallelPartials
+
+	~uParallelPartials() {
+	    for ( unsigned int i = 0; i < size; i += 1 ) partials[i].~Partial();
+	    ::free( partials );
+	} // uParallelPartials::~uParallelPartials
+
+	template<typename Op> void add( unsigned int id, const T &value, Op &op ) {
+	    Partial &p = partials[id];
+	    if ( p.used ) {
+		p.value = op( p.value, value );
+	    } else {
+		p.value = value;
+		p.used = true;
+	    } // if
+	} // uParallelPartials::add
+
+	template<typename Op> T combine( T init, Op &op ) {
+	    for ( unsigned int i = 0; i < size; i += 1 ) {
+		if ( partials[i].used ) init = op( init, partials[i].value );
+	    } // for
+	    return init;
+	} // uParallelPartials::combine
+    }; // uParallelPartials
+
+    inline unsigned int uParallelWorkers( uCluster &cluster ) {
+	unsigned int workers = cluster.getProcessors();
+	return workers != 0 ? workers : 1;
+    } // uParallelWorkers
+
+    // Number of elements of run a in the first d elements of the stable merge of runs a and b (merge path).
+    template<typename It, typename Comp>
+    size_t uParallelCorank( It a, size_t na, It b, size_t nb, size_t d, Comp &comp ) {
+	size_t low = d > nb ? d - nb : 0, high = d < na ? d : na;
+	while ( low < high ) {				// smallest i with b[d - i - 1] < a[i]
+	    size_t i = ( low + high ) / 2;
+	    if ( ! comp( b[d - i - 1], a[i] ) ) low = i + 1;
+	    else high = i;
+	} // while
+	return low;
+    } // uParallelCorank
+
+    template<typename Src, typename Dst, typename Comp>
+    void uParallelMergePass( uCluster &cluster, Src src, Dst dst, const std::vector<size_t> &bounds, size_t width, Comp &comp ) {
+	// Each merge of a pair of runs is split at co-ranked output positions into parts merged independently, so the
+	// last passes, with fewer pairs than workers, still use all workers. The split points are found before any
+	// element is moved.
+
+	size_t blocks = bounds.size() - 1, pairs = ( blocks + 2 * width - 1 ) / ( 2 * width );
+	unsigned int workers = uParallelWorkers( cluster );
+	size_t parts = ( workers + pairs - 1 ) / pairs;	// parts per merge
+	auto run = [&]( size_t p, size_t &left, size_t &mid, size_t &right ) { // merge blocks [left, mid) and [mid, right)
+	    left = bounds[2 * p * width];
+	    mid = bounds[std::min( 2 * p * width + width, blocks )];
+	    right = bounds[std::min( 2 * p * width + 2 * width, blocks )];
+	};
+
+	std::vector<size_t> splits( pairs * ( parts + 1 ) ); // elements from left run before each part
+	for ( size_t p = 0; p < pairs; p += 1 ) {
+	    size_t left, mid, right;
+	    run( p, left, mid, right );
+	    for ( size_t k = 0; k <= parts; k += 1 ) {
+		splits[p * ( parts + 1 ) + k] = uParallelCorank( src + left, mid - left, src + mid, right - mid, ( right - left ) * k / parts, comp );
+	    } // for
+	} // for
+
+	auto merge = [&]( size_t low, size_t high, unsigned int ) {
+	    for ( size_t s = low; s < high; s += 1 ) {
+		size_t p = s / parts, k = s % parts, left, mid, right;
+		run( p, left, mid, right );
+		size_t d0 = ( right - left ) * k / parts, d1 = ( right - left ) * ( k + 1 ) / parts;
+		size_t i0 = splits[p * ( parts + 1 ) + k], i1 = splits[p * ( parts + 1 ) + k + 1];
+		std::merge( std::make_move_iterator( src + left + i0 ), std::make_move_iterator( src + left + i1 ),
+			    std::make_move_iterator( src + mid + ( d0 - i0 ) ), std::make_move_iterator( src + mid + ( d1 - i1 ) ),
+			    dst + left + d0, comp );
+	    } // for
+	};
+	uParallelFor( cluster, pairs * parts, workers, merge );
+    } // uParallelMergePass
+} // UPP
+
+
+namespace uParallel {
+    template<typename RandomIt, typename Func>
+    void for_each( RandomIt first, RandomIt last, Func f, uCluster &cluster = uThisCluster() ) {
+	auto body = [&]( size_t low, size_t high, unsigned int ) {
+	    for ( size_t i = low; i < high; i += 1 ) f( first[i] );
+	};
+	UPP::uParallelFor( cluster, last - first, UPP::uParallelWorkers( cluster ), body );
+    } // for_each
+
+    template<typename RandomIt, typename OutIt, typename Op>
+    OutIt transform( RandomIt first, RandomIt last, OutIt out, Op op, uCluster &cluster = uThisCluster() ) {
+	auto body = [&]( size_t low, size_t high, unsigned int ) {
+	    for ( size_t i = low; i < high; i += 1 ) out[i] = op( first[i] );
+	};
+	UPP::uParallelFor( cluster, last - first, UPP::uParallelWorkers( cluster ), body );
+	return out + ( last - first );
+    } // transform
+
+    template<typename RandomIt, typename T, typename Reduce, typename Transform>
+    T transform_reduce( RandomIt first, RandomIt last, T init, Reduce reduce, Transform transform, uCluster &cluster = uThisCluster() ) {
+	unsigned int workers = UPP::uParallelWorkers( cluster );
+	UPP::uParallelPartials<T> partials( workers, init );
+	auto body = [&]( size_t low, size_t high, unsigned int id ) {
+	    T value = transform( first[low] );		// chunks are never empty
+	    for ( size_t i = low + 1; i < high; i += 1 ) value = reduce( value, transform( first[i] ) );
+	    partials.add( id, value, reduce );
+	};
+	UPP::uParallelFor( cluster, last - first, workers, body );
+	return partials.combine( init, reduce );
+    } // transform_reduce
+
+    template<typename RandomIt, typename T, typename Op>
+    T reduce( RandomIt first, RandomIt last, T init, Op op, uCluster &cluster = uThisCluster() ) {
+	return uParallel::transform_reduce( first, last, init, op, []( const T &value ) { return value; }, cluster );
+    } // reduce
+
+    template<typename RandomIt, typename OutIt, typename Op>
+    OutIt inclusive_scan( RandomIt first, RandomIt last, OutIt out, Op op, uCluster &cluster = uThisCluster() ) {
+	typedef typename std::iterator_traits<RandomIt>::value_type T;
+	enum { BlocksPerWorker = 4 };
+
+	size_t size = last - first;
+      if ( size == 0 ) return out;
+	size_t blocks = (size_t)UPP::uParallelWorkers( cluster ) * BlocksPerWorker;
+	if ( blocks > size ) blocks = size;
+	auto bound = [&]( size_t b ) { return size * b / blocks; };
+
+	// Each block is scanned in place after its total is known, so the second pass can start at the carry from the
+	// preceding blocks. A sequential pass over the block totals computes the carries.
+
+	std::vector<T> sums( blocks, first[0] );
+	auto total = [&]( size_t low, size_t high, unsigned int ) {
+	    for ( size_t b = low; b < high; b += 1 ) {
+		T sum = first[bound( b )];
+		for ( size_t i = bound( b ) + 1; i < bound( b + 1 ); i += 1 ) sum = op( sum, first[i] );
+		sums[b] = sum;
+	    } // for
+	};
+	UPP::uParallelFor( cluster, blocks, UPP::uParallelWorkers( cluster ), total );
+	for ( size_t b = 1; b < blocks; b += 1 ) sums[b] = op( sums[b - 1], sums[b] ); // inclusive carries
+
+	auto scan = [&]( size_t low, size_t high, unsigned int ) {
+	    for ( size_t b = low; b < high; b += 1 ) {
+		size_t i = bound( b );
+		T sum = b == 0 ? first[i] : op( sums[b - 1], first[i] );
+		out[i] = sum;
+		for ( i += 1; i < bound( b + 1 ); i += 1 ) {
+		    sum = op( sum, first[i] );
+		    out[i] = sum;
+		} // for
+	    } // for
+	};
+	UPP::uParallelFor( cluster, blocks, UPP::uParallelWorkers( cluster ), scan );
+	return out + size;
+    } // inclusive_scan
+
+    template<typename RandomIt, typename Comp>
+    void sort( RandomIt first, RandomIt last, Comp comp, uCluster &cluster = uThisCluster() ) {
+	typedef typename std::iterator_traits<RandomIt>::value_type T;
+	enum { MinBlock = 4096,				// smaller blocks are not worth merging
+	       BlocksPerWorker = 2 };
+
+	// Blocks are sorted in parallel, and then pairs of adjacent sorted runs are merged in parallel between the
+	// range and a buffer, doubling the run length each pass. Merges are split so every pass, including the final one
+	// of the two halves, runs on all workers.
+
+	size_t size = last - first, blocks = 1;
+	while ( blocks < (size_t)UPP::uParallelWorkers( cluster ) * BlocksPerWorker && size / ( blocks * 2 ) >= MinBlock ) blocks *= 2;
+	if ( blocks == 1 ) {
+	    std::sort( first, last, comp );
+	    return;
+	} // if
+	std::vector<size_t> bounds( blocks + 1 );
+	for ( size_t b = 0; b <= blocks; b += 1 ) bounds[b] = size * b / blocks;
+
+	auto sortBlocks = [&]( size_t low, size_t high, unsigned int ) {
+	    for ( size_t b = low; b < high; b += 1 ) std::sort( first + bounds[b], first + bounds[b + 1], comp );
+	};
+	UPP::uParallelFor( cluster, blocks, UPP::uParallelWorkers( cluster ), sortBlocks );
+
+	std::vector<T> buffer( first, last );
+	bool inBuffer = false;				// sorted runs in buffer ?
+	for ( size_t width = 1; width < blocks; width *= 2 ) {
+	    if ( inBuffer ) {
+		UPP::uParallelMergePass( cluster, buffer.begin(), first, bounds, width, comp );
+	    } else {
+		UPP::uParallelMergePass( cluster, first, buffer.begin(), bounds, width, comp );
+	    } // if
+	    inBuffer = ! inBuffer;
+	} // for
+	if ( inBuffer ) std::move( buffer.begin(), buffer.end(), first );
+    } // sort
+
+    template<typename RandomIt>
+    void sort( RandomIt first, RandomIt last ) {
+	uParallel::sort( first, last, std::less<typename std::iterator_traits<RandomIt>::value_type>() );
+    } // sort
+} // uParallel
+
+
+#pragma __U_USER_CODE__
+
+#endif // __U_PARALLEL_H__
+
+
+// Local Variables: //
+// compile-command: "make install" //
+// End: //
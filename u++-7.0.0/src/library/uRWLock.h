@@ -30,12 +30,58 @@
 
 #pragma __U_NOT_USER_CODE__
 
+// Readers normally take a fast path (BRAVO style) that only claims a reader slot for this task, so readers on different
+// processors seldom share a cache line. The slots form one table shared by all locks, so a lock costs no more space than
+// the original, and a slot is chosen by hashing the lock and task, so a reader releases the same slot even if it
+// migrates, and a reader finding its slot taken uses the normal path. An arriving writer revokes the fast path, so
+// later readers queue behind it as before, and once admitted waits for the fast readers of its lock to release their
+// slots. The fast path is restored by a reader after a period proportional to the last revocation, so frequent writers
+// see the original lock.
+
 class uRWLock {
     enum RW { READER, WRITER };				// kinds of tasks
+    enum { SlotBits = 10, Slots = 1 << SlotBits,	// reader slots shared by all locks, reduce hash collisions
+	   Inhibit = 9 };				// fast path off for this multiple of the revocation time
+
+    struct Slot {
+	uRWLock * volatile lock;			// lock read by fast-path reader holding slot, nullptr => free
+	uBaseTask * volatile reader;			// reader holding slot, set after claiming slot
+    };
+
     uSequence<uBaseTaskDL> waiting;
     // Cannot pass ownership of spinlock to another task.
     uSpinLock entry;
     unsigned int rwdelay, rcnt, wcnt;
+    volatile bool rbias;				// readers may use fast path
+    long long int inhibitUntil;				// fast path not restored before this time (nanoseconds), atomic access
+
+    static Slot *slots() {				// zero initialized at load, so no initialization guard
+	static Slot table[Slots] __attribute__(( aligned (uCacheLine()) ));
+	return table;
+    } // uRWLock::slots
+
+    Slot &slot( uBaseTask &task ) {			// Fibonacci hash of lock and task addresses
+	unsigned long long int key = (uintptr_t)this ^ ( (uintptr_t)&task >> 4 );
+	return slots()[( key * 0x9E3779B97F4A7C15ull ) >> ( 64 - SlotBits )];
+    } // uRWLock::slot
+
+    void revoke() {					// entry lock held
+	if ( rbias ) {
+	    rbias = false;
+	    __atomic_thread_fence( __ATOMIC_SEQ_CST );	// order revocation before reading slots
+	} // if
+    } // uRWLock::revoke
+
+    void drain() {					// writer, wait for fast-path readers of this lock to leave
+	uTime start = uThisProcessor().getClock().getTime();
+	Slot *table = slots();
+	for ( unsigned int i = 0; i < Slots; i += 1 ) {
+	    while ( table[i].lock == this ) uBaseTask::yield();
+	} // for
+	uTime end = uThisProcessor().getClock().getTime();
+	// Written outside the entry lock, so store atomically for readers restoring the fast path.
+	__atomic_store_n( &inhibitUntil, ( end + ( end - start ) * Inhibit ).nanoseconds(), __ATOMIC_RELAXED );
+    } // uRWLock::drain
 
     void wunblock() {
 	wcnt += 1;
@@ -59,24 +105,55 @@ class uRWLock {
 #endif // __U_STATISTICS__
     } // uRWLock::block
   public:
-    uRWLock() {
+    uRWLock( const uRWLock & ) = delete;		// no copy
+    uRWLock( uRWLock && ) = delete;
+    uRWLock &operator=( const uRWLock & ) = delete;	// no assignment
+
+    uRWLock() : rbias( true ), inhibitUntil( 0 ) {
 	rwdelay = rcnt = wcnt = 0;
     } // uRWLock::uRWLock
 
-    inline unsigned int rdcnt() const { return rcnt; }
+    unsigned int rdcnt() const {			// approximate while readers use the fast path
+	unsigned int cnt = rcnt;
+	Slot *table = slots();
+	for ( unsigned int i = 0; i < Slots; i += 1 ) cnt += table[i].lock == this;
+	return cnt;
+    } // uRWLock::rdcnt
     inline unsigned int wrcnt() const { return wcnt; }
 
     void rdacquire() {
+	uBaseTask &task = uThisTask();			// optimization
+	if ( rbias ) {					// fast path ?
+	    Slot &s = slot( task );
+	    if ( s.lock == nullptr && uCompareAssign( s.lock, (uRWLock *)nullptr, this ) ) {
+		s.reader = &task;			// only holder writes, cleared before slot freed
+	      if ( rbias ) return;			// recheck after claiming slot, writer drains slots
+		s.reader = nullptr;
+		__atomic_store_n( &s.lock, (uRWLock *)nullptr, __ATOMIC_RELEASE ); // revoked, back out
+	    } // if
+	} // if
+
 	entry.acquire();				// entry protocol
 	if ( wcnt > 0 || rwdelay > 0 ) {		// resource in use ?
 	    block( READER );
 	} else {
 	    rcnt += 1;
+	    if ( ! rbias && uThisProcessor().getClock().getTime().nanoseconds() >= __atomic_load_n( &inhibitUntil, __ATOMIC_RELAXED ) ) {
+		rbias = true;				// restore fast path
+	    } // if
 	    entry.release();				// put baton down
 	} // if
     } // uRWLock::rdacquire
 
     void rdrelease() {
+	uBaseTask &task = uThisTask();			// optimization
+	Slot &s = slot( task );
+	if ( s.lock == this && s.reader == &task ) {	// acquired on fast path ?
+	    s.reader = nullptr;
+	    __atomic_store_n( &s.lock, (uRWLock *)nullptr, __ATOMIC_RELEASE );
+	    return;
+	} // if
+
 	entry.acquire();				// exit protocol
 	rcnt -= 1;
 	if ( rcnt == 0 && rwdelay > 0 ) {		// last reader ?
@@ -88,12 +165,15 @@ class uRWLock {
 
     void wracquire() {
 	entry.acquire();				// entry protocol
+	bool revoked = rbias;
+	revoke();					// later readers use the queue
 	if ( rcnt > 0 || wcnt > 0 ) {			// resource in use ?
 	    block( WRITER );
 	} else {
 	    wcnt += 1;
 	    entry.release();				// put baton down
 	} // if
+	if ( revoked ) drain();				// fast-path readers admitted before revocation
     } // uRWLock::wracquire
 
     void wrrelease() {
@@ -37,8 +37,39 @@ using UPP::uSemaphore;
 #else
 
 _Monitor uSemaphore {
-    int count;						// semaphore counter
+    volatile int count;					// semaphore counter, changed atomically, negative => -count waiting tasks
     uCondition blockedTasks;
+
+    // While no task is waiting, the counter is non-negative and P and V complete with one atomic instruction without
+    // entering the monitor. A task blocks only after making the counter negative inside the monitor, so while it is
+    // negative, only the monitor changes it.
+
+    bool decrement() {					// counter positive ? then decrement
+	int c = __atomic_load_n( &count, __ATOMIC_RELAXED );
+	while ( c > 0 ) {
+	    if ( uCompareAssignValue( count, c, c - 1 ) ) return true;
+	} // while
+	return false;
+    } // uSemaphore::decrement
+
+    bool advance( int inc ) {				// no waiting tasks ? then increment
+	int c = __atomic_load_n( &count, __ATOMIC_RELAXED );
+	while ( c >= 0 ) {
+	    if ( uCompareAssignValue( count, c, c + inc ) ) return true;
+	} // while
+	return false;
+    } // uSemaphore::advance
+
+    _Mutex void block() {				// P when the semaphore may be unavailable
+	if ( uFetchAdd( count, -1 ) <= 0 ) blockedTasks.wait(); // if semaphore less than zero, wait for next V
+    } // uSemaphore::block
+
+    _Mutex void unblock( int inc ) {			// V when tasks may be waiting
+	uFetchAdd( count, inc );			// increment semaphore counter
+	for ( int i = 0; i < inc; i += 1 ) {		// wake up required number of tasks
+	    blockedTasks.signal();
+	} // for
+    } // uSemaphore::unblock
   public:
     uSemaphore( int count = 1 ) : count( count ) {
 #ifdef __U_STATISTICS__
@@ -51,58 +82,33 @@ _Monitor uSemaphore {
 #endif // __U_DEBUG__
     } // uSemaphore::uSemaphore
 
-    void P() {						// wait on a semaphore
-	count -= 1;					// decrement semaphore counter
-	if ( count < 0 ) blockedTasks.wait();		// if semaphore less than zero, wait for next V
+    _Nomutex void P() {					// wait on a semaphore
+	if ( ! decrement() ) block();
     } // uSemaphore::P
 
-    // This routine forces the implementation to use internal scheduling, otherwise there is a deadlock problem with    // accepting V in the previous P routine, which prevents calls entering this routine to V the parameter and wait.
-    // Essentially, it is necessary to enter the monitor and do some work *before* possibly blocking. To use external
-    // scheduling requires accepting either the V routine OR this P routine, which is currently impossible because there
-    // is no differentiation between overloaded routines.
-    //
-    //  _Monitor Semaphore {
-    //      int cnt;
-    //    public:
-    //      Semaphore( int cnt = 1 ) : cnt(cnt) {}
-    //      void V() {
-    //  	cnt += 1;
-    //      }
-    //      void P() {
-    //  	if ( cnt == 0 ) _Accept( V, P( Semaphore ) );
-    //  	cnt -= 1;
-    //      }
-    //      void P( Semaphore &s ) {
-    //  	s.V();
-    //  	P();  // reuse code
-    //      }
-    //  };
-    //
-    // I'm not sure the external scheduling solution would be any more efficient than the internal scheduling solution.
-
-    void P( uSemaphore &s ) {				// wait on a semaphore and release another
+    // V on the other semaphore and P on this one each try an atomic fast path without entering a monitor: V advances
+    // the other counter when no task waits on it (counter non-negative), and P decrements this counter when it is
+    // positive. Otherwise, the slow path enters the corresponding monitor, where V advances the counter and wakes the
+    // waiting tasks, and P decrements the counter and waits if it becomes negative. The other semaphore is released
+    // before this one is acquired, so a task restarted by the V may run before this task blocks, as with separate V and
+    // P calls.
+
+    _Nomutex void P( uSemaphore &s ) {			// wait on a semaphore and release another
 	s.V();						// release other semaphore
 	P();						// wait
     } // uSemaphore::P
 
-    bool TryP() {					// conditionally wait on a semaphore
-      if ( count > 0 ) {
-	    count -= 1;					// decrement semaphore counter
-	    return true;
-	};
-	return false;
+    _Nomutex bool TryP() {				// conditionally wait on a semaphore
+	return decrement();
     } // uSemaphore::TryP
 
-    void V( int inc = 1 ) {				// signal a semaphore
+    _Nomutex void V( int inc = 1 ) {			// signal a semaphore
 #ifdef __U_DEBUG__
 	if ( inc < 0 ) {
 	    abort( "Attempt to advance uSemaphore %p to %d that must be >= 0.", this, inc );
 	} // if
 #endif // __U_DEBUG__
-	count += inc;					// increment semaphore counter
-	for ( int i = 0; i < inc; i += 1 ) {		// wake up required number of tasks
-	    blockedTasks.signal();
-	} // for
+	if ( ! advance( inc ) ) unblock( inc );		// semaphore not accessed after fast increment
     } // uSemaphore::V
 
     _Nomutex int counter() const {			// semaphore counter
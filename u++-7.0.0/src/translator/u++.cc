@@ -685,6 +685,11 @@ int main( int argc, char *argv[] ) {
     nargs += 1;
 #endif // STATISTICS
 
+#if defined( QUEUELOCK )				// Kernel queue locks ?
+    args[nargs] = "-D__U_QUEUELOCK__";
+    nargs += 1;
+#endif // QUEUELOCK
+
 #if defined( AFFINITY )					// Thread Local Storage ?
     args[nargs] = "-D__U_AFFINITY__";
     nargs += 1;